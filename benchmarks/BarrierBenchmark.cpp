@@ -0,0 +1,38 @@
+/*
+   Copyright 2022 Rishi Challa
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+	   http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+
+#include <Kale/Core/Barrier/Barrier.hpp>
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <thread>
+
+/**
+ * Sweeps the barrier across thread counts up to the hardware concurrency (or the first argument), printing the average latency
+ * of a single phase at each count
+ */
+int main(int argc, char** argv) {
+	size_t maxThreads = argc > 1 ? static_cast<size_t>(std::strtoul(argv[1], nullptr, 10)) :
+		std::max<size_t>(std::thread::hardware_concurrency(), 2);
+	size_t iterations = argc > 2 ? static_cast<size_t>(std::strtoul(argv[2], nullptr, 10)) : 100000;
+
+	std::printf("threads  latency (us)\n");
+	for (size_t numThreads = 1; numThreads <= maxThreads; numThreads++)
+		std::printf("%7zu  %12.3f\n", numThreads, Kale::Barrier::benchmark(numThreads, iterations));
+	return 0;
+}
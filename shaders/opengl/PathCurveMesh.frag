@@ -0,0 +1,33 @@
+/*
+   Copyright 2022 Rishi Challa
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+	   http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+
+#version 410
+
+uniform vec4 color;
+
+in vec3 fragKLM;
+
+out vec4 outColor;
+
+/**
+ * Entry point
+ */
+void main() {
+	// The implicit form of the cubic is negative between the curve and the line joining its ends
+	if (fragKLM.x * fragKLM.x * fragKLM.x - fragKLM.y * fragKLM.z > 0.0) discard;
+	outColor = color;
+}
@@ -16,18 +16,18 @@
 
 #version 410
 
-#define MAX_BEZIERS 128
 #define PI 3.1415926538
 
-uniform vec4 vertexColor;
-uniform vec4 strokeColor;
-uniform vec2[MAX_BEZIERS * 4] beziers;
-uniform float strokeRadius;
-uniform int numBeziers;
-uniform int fill;
-uniform int stroke; // Neither = 0, Both = 1, Inside = 2, Outside = 3
+uniform samplerBuffer beziers; // Two texels per segment, (start, control point 1) & (control point 2, end), followed by the tiles
 
 in vec2 fragPos;
+flat in vec4 vertexColor;
+flat in vec4 strokeColor;
+flat in float strokeRadius;
+flat in int bezierOffset;
+flat in int tileOffset;
+flat in int fill;
+flat in int stroke; // Neither = 0, Both = 1, Inside = 2, Outside = 3
 
 out vec4 outColor;
 
@@ -271,20 +271,31 @@ bool shouldStrokeBezier(vec2 p0, vec2 p1, vec2 p2, vec2 p3, vec2 p) {
  */
 void main() {
 
+	// Find the tile of the path's grid this fragment lies within, the grid starts with its origin, tile size & dimensions
+	vec4 grid = texelFetch(beziers, bezierOffset + tileOffset);
+	ivec2 gridSize = floatBitsToInt(texelFetch(beziers, bezierOffset + tileOffset + 1).xy);
+	ivec2 tile = clamp(ivec2(floor((fragPos - grid.xy) / grid.zw)), ivec2(0), gridSize - 1);
+
+	// The tile lists the segments near it or crossing the row to its right, segments spanning the whole row are counted upfront
+	ivec4 header = floatBitsToInt(texelFetch(beziers, bezierOffset + tileOffset + 2 + tile.y * gridSize.x + tile.x));
+
 	// Calculate whether or not the fragment is in the shape by using even-odd test
-	int numCollisions = 0;
+	int numCollisions = header.z;
 	bool shouldStroke = false;
 	vec2 lineStart = fragPos;
 	vec2 lineEnd = vec2(fragPos.x + 10000000.0, fragPos.y);
 
-	// Loop through the beziers
-	for (int i = 0; i < numBeziers; i++) {
-
-		// Fetch the bezier from the uniforms
-		vec2 p0 = beziers[4*i];
-		vec2 p1 = beziers[4*i + 1];
-		vec2 p2 = beziers[4*i + 2];
-		vec2 p3 = beziers[4*i + 3];
+	// Loop through the segments listed within the tile
+	for (int listed = header.x; listed < header.x + header.y; listed++) {
+		int i = floatBitsToInt(texelFetch(beziers, bezierOffset + listed / 4))[listed % 4];
+
+		// Fetch the segment from the path's range of the beziers buffer
+		vec4 first = texelFetch(beziers, bezierOffset + 2*i);
+		vec4 second = texelFetch(beziers, bezierOffset + 2*i + 1);
+		vec2 p0 = first.xy;
+		vec2 p1 = first.zw;
+		vec2 p2 = second.xy;
+		vec2 p3 = second.zw;
 		float maxX = max4(p0.x, p1.x, p2.x, p3.x), maxY = max4(p0.y, p1.y, p2.y, p3.y),
 			minX = min4(p0.x, p1.x, p2.x, p3.x), minY = min4(p0.y, p1.y, p2.y, p3.y);
 
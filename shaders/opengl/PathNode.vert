@@ -17,12 +17,23 @@
 #version 410
 
 uniform mat3 camera;
-uniform mat3 local;
-uniform float zPosition;
+uniform samplerBuffer instances;
 
-in vec2 pos;
+in vec2 corner;
 
 out vec2 fragPos;
+flat out vec4 vertexColor;
+flat out vec4 strokeColor;
+flat out float strokeRadius;
+flat out int bezierOffset;
+flat out int tileOffset;
+flat out int fill;
+flat out int stroke;
+
+/**
+ * The number of texels of per path data within the instances buffer
+ */
+const int TEXELS_PER_INSTANCE = 6;
 
 /**
  * Helper function to transform a vector by a transformation matrix
@@ -34,17 +45,28 @@ vec2 transform(mat3 mat, vec2 vert) {
 	);
 }
 
-/**
- * Transforms a position vector by the camera and local transforms
- */
-vec2 transformPosition(vec2 pos) {
-	return transform(camera, transform(local, pos));
-}
-
 /**
  * Entry point
  */
 void main() {
-	gl_Position = vec4(transformPosition(pos), zPosition, 1.0);
+	// Fetch this path's data, the first two texels hold the rows of the local transform with the z position & stroke radius
+	int instance = gl_InstanceID * TEXELS_PER_INSTANCE;
+	vec4 localRow0 = texelFetch(instances, instance);
+	vec4 localRow1 = texelFetch(instances, instance + 1);
+	vec4 bounds = texelFetch(instances, instance + 2);
+	ivec4 path = floatBitsToInt(texelFetch(instances, instance + 5));
+
+	// Stretch the unit quad over the path's bounding box
+	vec2 pos = mix(bounds.xy, bounds.zw, corner);
+	vec2 localPos = vec2(dot(localRow0.xyz, vec3(pos, 1.0)), dot(localRow1.xyz, vec3(pos, 1.0)));
+	gl_Position = vec4(transform(camera, localPos), localRow0.w, 1.0);
+
 	fragPos = pos;
+	vertexColor = texelFetch(instances, instance + 3);
+	strokeColor = texelFetch(instances, instance + 4);
+	strokeRadius = localRow1.w;
+	bezierOffset = path.x;
+	tileOffset = path.y;
+	fill = path.z;
+	stroke = path.w;
 }
@@ -27,6 +27,7 @@
 #include <Kale/Engine/Engine.hpp>
 
 #include <exception>
+#include <algorithm>
 #include <chrono>
 #include <string>
 
@@ -46,7 +47,7 @@ std::vector<std::function<void()>> Application::nodeCleanupFuncs = { PathNode::c
  * Creates a new application instance
  * @param applicationName The name of your application
  */
-Application::Application(const char* applicationName) noexcept : applicationName(applicationName) {
+Application::Application(const char* applicationName) noexcept : running(false), applicationName(applicationName) {
 	try {
 		console.load(this->applicationName);
 	}
@@ -91,7 +92,9 @@ std::shared_ptr<const Scene> Application::getPresentedScene() const noexcept {
  * @returns The number of threads used for updating
  */
 size_t Application::getNumUpdateThreads() const noexcept {
-	return updateThreads.size();
+	// Prior to running the threads don't exist yet, so use the number they will be created with
+	if (numUpdateThreads == 0) return threadPoolConfig.getWorkerCount();
+	return numUpdateThreads;
 }
 
 /**
@@ -103,13 +106,20 @@ void Application::presentScene(const std::shared_ptr<Scene>& scene) {
 }
 
 /**
- * Runs a given task on the main thread prior to rendering on any given frame, Can be called on any thread
+ * Runs a given task on the main thread prior to rendering on any given frame, Can be called on any thread. Tasks pushed by one
+ * thread, or otherwise pushed one after another, run in the order pushed. Tasks pushed concurrently by different threads have
+ * no defined order.
  * @note Do not use reference based lambdas if anything referenced is at risk of being destroyed.
  * @param task A method which carries out any necessary task
  */
-void Application::runTaskOnMainThread(std::function<void()> task) {
-	std::lock_guard lock(taskManagerMutex);
-	tasks.push(task);
+void Application::runTaskOnMainThread(Task task) {
+	if (!tasksOverflowed.load(std::memory_order_acquire) && tasks.push(std::move(task))) return;
+
+	// The queue is full or tasks are already waiting in the overflow, fall back to the locked overflow so the task is never
+	// dropped and runs after every task pushed before it
+	std::lock_guard lock(taskOverflowMutex);
+	overflowTasks.push_back(std::move(task));
+	tasksOverflowed.store(true, std::memory_order_release);
 }
 
 /**
@@ -120,23 +130,6 @@ std::string Application::getAssetFolderPath() const {
 	return "." + applicationName + "/assets/";
 }
 
-/**
- * Synchronizes udpates
- */
-void Application::synchronizeUpdate() {
-	std::unique_lock lock(threadSyncMutex);
-	numThreadsUpdated--;
-	renderingFinished = false;
-
-	if (numThreadsUpdated == 0) {
-		updatingFinished = true;
-		numThreadsUpdated = getNumUpdateThreads();
-		renderSyncCondVar.notify_one();
-	}
-
-	threadSyncCondVar.wait(lock, [&]() -> bool { return renderingFinished; });
-}
-
 /**
  * Handles updating the application in a separate thread
  * @param threadNum the index of this thread, ranged 0 - numUpdateThreads
@@ -144,10 +137,11 @@ void Application::synchronizeUpdate() {
 void Application::update(size_t threadNum) noexcept {
 
 	// Update loop
-	while (window.isOpen()) {
+	while (true) {
 
 		// Wait until we should update
-		synchronizeUpdate();
+		frameBarrier->arriveAndWait();
+		if (!running.load(std::memory_order_relaxed)) break;
 
 		// Perform updating
 		if (presentedScene != nullptr) try {
@@ -156,10 +150,120 @@ void Application::update(size_t threadNum) noexcept {
 		catch (const std::exception& e) {
 			console.error("Failed to update presented screen on update thread " + std::to_string(threadNum) + " - " + e.what());
 		}
+
+		// Let the main thread know updating is finished
+		frameBarrier->arriveAndWait();
+	}
+}
+
+/**
+ * Renders the last render snapshot of the rendered scene
+ */
+void Application::render() noexcept {
+	using namespace std::string_literals;
+	
+	if (renderedScene != nullptr) try {
+		if (fixedUpdateRate > 0.0f) renderedScene->interpolateRenderSnapshots(renderAlpha);
+		renderedScene->render(frameTime);
+	}
+	catch (const std::exception& e) {
+		console.error("Failed to render presented scene - "s + e.what());
+	}
+}
+
+/**
+ * Runs the tasks queued to run on the main thread until the deadline passes, the remaining tasks are run in later frames.
+ * At least one task is always run.
+ * @param deadline The time to stop running tasks at
+ */
+void Application::runTasks(std::chrono::steady_clock::time_point deadline) noexcept {
+	using namespace std::string_literals;
+
+	// Runs a single task, logging any exceptions thrown
+	const auto runTask = [&](Task& task) {
+		try {
+			task();
+		}
+		catch (const std::exception& e) {
+			console.error("Failed to execute task on main thread - "s + e.what());
+		}
+	};
+
+	while (std::optional<Task> task = tasks.pop()) {
+		runTask(*task);
+		if (std::chrono::steady_clock::now() >= deadline) return;
+	}
+
+	// Run any tasks which overflowed the queue, every task in the queue is older as tasks are only pushed to the overflow while
+	// it holds tasks
+	std::vector<Task> overflow;
+	{
+		std::lock_guard lock(taskOverflowMutex);
+		overflow.swap(overflowTasks);
+	}
+	for (size_t i = 0; i < overflow.size(); i++) {
+		runTask(overflow[i]);
+		if (i + 1 == overflow.size() || std::chrono::steady_clock::now() < deadline) continue;
+
+		// Put the tasks out of time back ahead of any overflowed since
+		std::lock_guard lock(taskOverflowMutex);
+		overflowTasks.insert(overflowTasks.begin(), std::make_move_iterator(overflow.begin() + i + 1),
+			std::make_move_iterator(overflow.end()));
+		return;
+	}
+
+	// Once the overflow has been run, new tasks can be pushed to the queue again
+	std::lock_guard lock(taskOverflowMutex);
+	if (overflowTasks.empty()) tasksOverflowed.store(false, std::memory_order_release);
+}
+
+/**
+ * Begins the nodes loaded by the scenes loading from a file until the deadline passes, forgetting the scenes once loaded
+ * @param deadline The time to stop beginning nodes at
+ * @param updatePresentedScene Whether or not to update the presented scene's node structures, for frames where no tick has
+ */
+void Application::updateLoadingScenes(std::chrono::steady_clock::time_point deadline, bool updatePresentedScene) noexcept {
+	using namespace std::string_literals;
+
+	// The presented scene is otherwise only updated by ticks, its new nodes are snapshotted as they begin
+	if (updatePresentedScene && presentedScene != nullptr) try {
+		presentedScene->updateNodeStructures(deadline);
+		frameRecorder.recordStructureChange(0, presentedScene->lastStructureChange);
+		frameRecorder.checkStructureChange(0, presentedScene->lastStructureChange);
+	}
+	catch (const std::exception& e) {
+		console.error("Failed to update presented scene - "s + e.what());
+	}
+
+	std::lock_guard lock(loadingScenesMutex);
+	for (Scene* scene : loadingScenes) {
+		if (scene == presentedScene.get() || std::chrono::steady_clock::now() >= deadline) continue;
+		try {
+			scene->updateNodeStructures(deadline);
+		}
+		catch (const std::exception& e) {
+			console.error("Failed to load scene - "s + e.what());
+		}
 	}
+	std::erase_if(loadingScenes, [](Scene* scene) { return scene->loader->isLoaded(); });
+}
+
+/**
+ * Starts beginning the loaded nodes of a scene loading from a file every frame, can be called on any thread
+ * @param scene The scene
+ */
+void Application::addLoadingScene(Scene* scene) {
+	std::lock_guard lock(loadingScenesMutex);
+	loadingScenes.push_back(scene);
+}
 
-	// Avoid the main thread waiting for update threads which are already finished
-	synchronizeUpdate();
+/**
+ * Stops beginning the loaded nodes of a scene, called when the scene is destroyed. Can be called on any thread.
+ * @param scene The scene
+ */
+void Application::removeLoadingScene(Scene* scene) {
+	std::lock_guard lock(loadingScenesMutex);
+	std::erase(loadingScenes, scene);
 }
 
 /**
@@ -170,6 +274,9 @@ void Application::run() noexcept {
 	using namespace std::string_literals;
 	using namespace std::chrono_literals;
 	
+	// Find the number of update threads once, before any scene sizes its per thread state or the render thread is configured
+	numUpdateThreads = threadPoolConfig.getWorkerCount();
+
 	// Creates the window
 	window.create(applicationName.c_str());
 	
@@ -200,10 +307,42 @@ void Application::run() noexcept {
 		return;
 	}
 
+	// Start recording or replaying, replays take the place of live input
+	try {
+		if (!replayFile.empty()) {
+			frameRecorder.startReplay(replayFile);
+			window.setLiveEvents(false);
+		}
+		else if (!recordingFile.empty()) {
+			frameRecorder.startRecording(recordingFile);
+			window.registerEvents(&frameRecorder);
+		}
+	}
+	catch (const std::exception& e) {
+		console.error((!replayFile.empty() ? "Failed to start replaying frames - "s : "Failed to start recording frames - "s) + e.what());
+	}
+
 	// Create update threads
-	numThreadsUpdated = std::thread::hardware_concurrency();
-	for (size_t i = 0; i < std::thread::hardware_concurrency(); i++)
+	frameBarrier = std::make_unique<Barrier>(numUpdateThreads + 1);
+	running.store(true, std::memory_order_relaxed);
+	updateAccumulator = 0.0f;
+	renderAlpha = 1.0f;
+	for (size_t i = 0; i < numUpdateThreads; i++) {
 		updateThreads.emplace_back(&Application::update, this, i);
+		if (threadPoolConfig.workerAffinity.empty()) continue;
+		if (!ThreadPoolConfig::setAffinity(updateThreads.back(), threadPoolConfig.workerAffinity[i % threadPoolConfig.workerAffinity.size()]))
+			console.warn("Failed to set the affinity of update thread " + std::to_string(i));
+	}
+
+	// Configure the render thread once the update threads exist, as new threads inherit the creating thread's affinity & priority
+	if (!ThreadPoolConfig::setCurrentThreadAffinity(threadPoolConfig.renderThreadAffinity))
+		console.warn("Failed to set the render thread affinity");
+	if (threadPoolConfig.renderThreadPriority.has_value() && !ThreadPoolConfig::setCurrentThreadPriority(*threadPoolConfig.renderThreadPriority))
+		console.warn("Failed to set the render thread priority");
+
+	// Recorded runs must add the same nodes each frame when replayed, so aren't limited by the main thread budget
+	bool budgeted = mainThreadBudget > 0.0f && !frameRecorder.isRecording() && !frameRecorder.isReplaying();
+	bool rendering = replayRendering || !frameRecorder.isReplaying();
 
 	// Render loop
 	auto previousTime = std::chrono::high_resolution_clock::now();
@@ -214,9 +353,29 @@ void Application::run() noexcept {
 
 		// Calculate FPS
 		auto currentTime = std::chrono::high_resolution_clock::now();
-		deltaTime = static_cast<float>(std::chrono::duration_cast<std::chrono::microseconds>(currentTime - previousTime).count());
+		frameTime = static_cast<float>(std::chrono::duration_cast<std::chrono::microseconds>(currentTime - previousTime).count());
 		previousTime = std::chrono::high_resolution_clock::now();
 
+		// Replays take the recorded frame time and input in place of the measured ones
+		if (frameRecorder.isReplaying()) try {
+			if (!frameRecorder.replayFrame(window.eventHandlers, frameTime)) break;
+		}
+		catch (const std::exception& e) {
+			console.error("Failed to replay frame - "s + e.what());
+			break;
+		}
+		frameRecorder.recordFrame(frameTime);
+
+		// Work out how many update ticks to run this frame, a fixed update rate may run several or none
+		size_t numTicks = 1;
+		deltaTime = frameTime;
+		if (fixedUpdateRate > 0.0f) {
+			deltaTime = 1000000.0f / fixedUpdateRate;
+			updateAccumulator = std::min(updateAccumulator + frameTime, deltaTime * static_cast<float>(maxUpdatesPerFrame));
+			numTicks = static_cast<size_t>(updateAccumulator / deltaTime);
+			updateAccumulator -= deltaTime * static_cast<float>(numTicks);
+		}
+
 		// Check if scene has changed prior to updating
 		if (sceneToPresent != nullptr) {
 			try {
@@ -230,38 +389,73 @@ void Application::run() noexcept {
 			}
 		}
 
-		// Synchronize with the update threads
-		{
-			std::unique_lock lock(threadSyncMutex);
-			updatingFinished = false;
-			renderingFinished = true;
-			threadSyncCondVar.notify_all();
-			renderSyncCondVar.wait(lock, [&]() -> bool { return updatingFinished; });
-		}
+		// Returns the time the main thread's work may run until, within what is left of this frame's main thread budget
+		float mainThreadTimeLeft = mainThreadBudget;
+		const auto getMainThreadDeadline = [&]() -> std::chrono::steady_clock::time_point {
+			if (!budgeted) return std::chrono::steady_clock::time_point::max();
+			return std::chrono::steady_clock::now() +
+				std::chrono::duration_cast<std::chrono::steady_clock::duration>(std::chrono::duration<float, std::micro>(mainThreadTimeLeft));
+		};
 
-		// Run all tasks required
-		while (!tasks.empty()) try {
-			tasks.front()();
-			tasks.pop();
-		}
-		catch (const std::exception& e) {
-			console.error("Failed to execute task on main thread - "s + e.what());
-		}
+		// Run the tasks once a frame however many ticks run, the update threads are still waiting so tasks may modify the scene
+		auto tasksStart = std::chrono::steady_clock::now();
+		runTasks(getMainThreadDeadline());
+		mainThreadTimeLeft -= std::chrono::duration<float, std::micro>(std::chrono::steady_clock::now() - tasksStart).count();
 
-		if (presentedScene != nullptr) try {
-			// Update node structures
-			presentedScene->updateNodeStructures();
-			// Render scene
-			presentedScene->render(deltaTime);
-		}
-		catch (const std::exception& e) {
-			console.error("Failed to render presented scene - "s + e.what());
+		bool rendered = false;
+		for (size_t tick = 0; tick < numTicks; tick++) {
+
+			// Distribute this tick's node updates across the update threads
+			if (presentedScene != nullptr) presentedScene->scheduleUpdates(deltaTime);
+
+			// Release the update threads
+			frameBarrier->arriveAndWait();
+
+			// When pipelining, render the previous frame's snapshot while the update threads update this frame
+			if (pipelinedRendering && rendering && !rendered) {
+				render();
+				rendered = true;
+			}
+
+			// Wait for the update threads to finish updating
+			frameBarrier->arriveAndWait();
+
+			// Begin the added nodes within what is left of this frame's main thread budget
+			auto mainThreadStart = std::chrono::steady_clock::now();
+			auto mainThreadDeadline = getMainThreadDeadline();
+			if (presentedScene != nullptr) try {
+				// Update node structures
+				presentedScene->updateNodeStructures(mainThreadDeadline);
+				frameRecorder.recordStructureChange(static_cast<uint32_t>(tick), presentedScene->lastStructureChange);
+				frameRecorder.checkStructureChange(static_cast<uint32_t>(tick), presentedScene->lastStructureChange);
+				// Snapshot the scene for rendering
+				presentedScene->takeRenderSnapshots();
+			}
+			catch (const std::exception& e) {
+				console.error("Failed to snapshot presented scene - "s + e.what());
+			}
+			renderedScene = presentedScene;
+			mainThreadTimeLeft -= std::chrono::duration<float, std::micro>(std::chrono::steady_clock::now() - mainThreadStart).count();
 		}
+
+		// Preload the scenes loading in the background with what is left of this frame's main thread budget, including the
+		// presented scene when no tick has run this frame to add, remove & wake its nodes
+		updateLoadingScenes(getMainThreadDeadline(), numTicks == 0);
+
+		// The leftover time decides how far between the last two snapshots the rendered frame lies
+		if (fixedUpdateRate > 0.0f) renderAlpha = updateAccumulator / deltaTime;
+
+		// Render scene
+		if (rendering && !rendered) render();
+		frameRecorder.measureReplayedFrame(std::chrono::duration<float, std::micro>(std::chrono::high_resolution_clock::now() -
+			previousTime).count());
 	}
+	frameRecorder.finish();
+	window.removeEvents(&frameRecorder);
 
 	// Wait for threads
-	renderingFinished = true;
-	threadSyncCondVar.notify_all();
+	running.store(false, std::memory_order_relaxed);
+	frameBarrier->arriveAndWait();
 	for (std::thread& thread : updateThreads) thread.join();
 
 	onEnd();
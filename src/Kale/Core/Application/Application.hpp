@@ -19,6 +19,11 @@
 #include <Kale/Core/Window/Window.hpp>
 #include <Kale/Core/Logger/Logger.hpp>
 #include <Kale/Core/Scene/Scene.hpp>
+#include <Kale/Core/Barrier/Barrier.hpp>
+#include <Kale/Core/MPSCQueue/MPSCQueue.hpp>
+#include <Kale/Core/Task/Task.hpp>
+#include <Kale/Core/ThreadPoolConfig/ThreadPoolConfig.hpp>
+#include <Kale/Core/FrameRecorder/FrameRecorder.hpp>
 
 #include <string>
 #include <memory>
@@ -26,9 +31,9 @@
 #include <list>
 #include <vector>
 #include <mutex>
-#include <queue>
 #include <functional>
-#include <condition_variable>
+#include <atomic>
+#include <chrono>
 
 /**
  * The entry point function/main function of the program
@@ -59,49 +64,74 @@ namespace Kale {
 		std::list<std::thread> updateThreads;
 
 		/**
-		 * Stores all tasks required to be run
+		 * The number of update threads the application runs with, found once when run before any scene is created so every scene
+		 * sizes its per thread state to match. 0 until the application is run.
 		 */
-		std::queue<std::function<void()>> tasks;
+		size_t numUpdateThreads = 0;
 
 		/**
-		 * Used for thread synchronization
+		 * Stores all tasks required to be run, pushed to from any thread and drained by the main thread
 		 */
-		std::mutex threadSyncMutex;
+		MPSCQueue<Task> tasks;
 
 		/**
-		 * Used for synchronizing access to tasks across threads
+		 * Stores tasks pushed while the task queue was full
 		 */
-		std::mutex taskManagerMutex;
+		std::vector<Task> overflowTasks;
 
 		/**
-		 * Used for thread synchronization
+		 * Used for synchronizing access to the overflow tasks across threads
 		 */
-		std::condition_variable threadSyncCondVar;
+		std::mutex taskOverflowMutex;
 
 		/**
-		 * Used for thread synchronization
+		 * Whether or not tasks have overflowed and not all been run yet, new tasks are then pushed behind them to the overflow so
+		 * each thread's tasks still run in the order they were pushed. The flag is read before pushing rather than in the same
+		 * atomic step, so tasks pushed concurrently by different threads have no defined order.
 		 */
-		std::condition_variable renderSyncCondVar;
+		std::atomic<bool> tasksOverflowed = false;
 
 		/**
-		 * Used for thread synchronization
+		 * Barrier used for synchronizing the main thread with the update threads, passed twice each frame. Once to start
+		 * updating and once when updating has finished. Created once the number of update threads is known.
 		 */
-		size_t numThreadsUpdated;
+		std::unique_ptr<Barrier> frameBarrier;
 
 		/**
-		 * Used for thread synchronization
+		 * Whether or not the update threads should keep running, only changed by the main thread prior to the frame barrier
 		 */
-		bool updatingFinished;
+		std::atomic<bool> running;
 
 		/**
-		 * Used for thread synchronization
+		 * The time step passed to updates, the fixed step when running at a fixed update rate and otherwise the frame time
 		 */
-		bool renderingFinished;
+		float deltaTime;
 
 		/**
-		 * The time taken to update and render each frame, set at the end of every render
+		 * The time taken to update and render the last frame, set at the start of every frame
 		 */
-		float deltaTime;
+		float frameTime;
+
+		/**
+		 * The time not yet simulated when running at a fixed update rate
+		 */
+		float updateAccumulator;
+
+		/**
+		 * How far between the last two render snapshots the rendered frame lies when running at a fixed update rate
+		 */
+		float renderAlpha;
+
+		/**
+		 * The scenes loading from a file, their loaded nodes are begun every frame whether or not they are presented
+		 */
+		std::vector<Scene*> loadingScenes;
+
+		/**
+		 * Used for synchronizing access to the loading scenes, as scenes may be created and destroyed on any thread. Declared ahead of
+		 * the scenes so it outlives them.
+		 */
+		std::mutex loadingScenesMutex;
 
 		/**
 		 * A pointer to the current scene to render
@@ -113,6 +143,16 @@ namespace Kale {
 		 */
 		std::shared_ptr<Scene> sceneToPresent;
 
+		/**
+		 * A pointer to the scene the last render snapshot was taken from
+		 */
+		std::shared_ptr<Scene> renderedScene;
+
+		/**
+		 * Records or replays the frames of this run when a recording or replay file is set
+		 */
+		FrameRecorder frameRecorder;
+
 		/**
 		 * Handles updating the application in a separate thread
 		 * @param threadNum the index of this thread, ranged 0 - numUpdateThreads
@@ -120,9 +160,37 @@ namespace Kale {
 		void update(size_t threadNum) noexcept;
 
 		/**
-		 * Synchronizes udpates
+		 * Renders the last render snapshot of the rendered scene
+		 */
+		void render() noexcept;
+
+		/**
+		 * Runs the tasks queued to run on the main thread until the deadline passes, the remaining tasks are run in later frames.
+		 * At least one task is always run.
+		 * @param deadline The time to stop running tasks at
+		 */
+		void runTasks(std::chrono::steady_clock::time_point deadline) noexcept;
+
+		/**
+		 * Begins the nodes loaded by the scenes loading from a file until the deadline passes, forgetting the scenes once loaded
+		 * @param deadline The time to stop beginning nodes at
+		 * @param updatePresentedScene Whether or not to update the presented scene's node structures, for frames where no tick has
+		 */
+		void updateLoadingScenes(std::chrono::steady_clock::time_point deadline, bool updatePresentedScene) noexcept;
+
+		/**
+		 * Starts beginning the loaded nodes of a scene loading from a file every frame, can be called on any thread
+		 * @param scene The scene
 		 */
-		void synchronizeUpdate();
+		void addLoadingScene(Scene* scene);
+
+		/**
+		 * Stops beginning the loaded nodes of a scene, called when the scene is destroyed. Can be called on any thread.
+		 * @param scene The scene
+		 */
+		void removeLoadingScene(Scene* scene);
+
+		friend class Scene;
 	
 	protected:
 
@@ -131,6 +199,56 @@ namespace Kale {
 		 */
 		Window window;
 
+		/**
+		 * Configures the number of update threads, their affinity and the render thread's affinity & priority. Must be set in
+		 * the application's constructor, before any scenes are created, as scenes size their per thread structures from it.
+		 */
+		ThreadPoolConfig threadPoolConfig;
+
+		/**
+		 * Whether or not to render the previous frame's snapshot while the update threads update the next frame. This hides the
+		 * cost of rendering behind updating at the cost of a frame of latency. Must be set before the application is run.
+		 */
+		bool pipelinedRendering = false;
+
+		/**
+		 * The number of updates per second to simulate at, or 0 to update once per rendered frame with the frame time. With a fixed
+		 * rate, a frame runs as many updates as the elapsed time covers and renders transforms interpolated between the last two
+		 * updates. Must be set before the application is run.
+		 */
+		float fixedUpdateRate = 0.0f;
+
+		/**
+		 * The maximum number of fixed rate updates to run in a single frame, time beyond this is dropped rather than caught up on
+		 */
+		size_t maxUpdatesPerFrame = 5;
+
+		/**
+		 * The time in microseconds each frame may spend running main thread tasks and beginning newly added nodes, anything beyond
+		 * is carried over to later frames so streaming content in doesn't cause hitches. At least one task and one node are always
+		 * processed per update. Defaults to 0 for no limit, where every task and added node is processed within the frame.
+		 */
+		float mainThreadBudget = 0.0f;
+
+		/**
+		 * The file to record every frame's time, input events and node structure changes to so the run can be replayed, empty to
+		 * not record. Recording disables the main thread budget so the same nodes are added each frame when replayed. Must be set
+		 * before the application is run.
+		 */
+		std::string recordingFile;
+
+		/**
+		 * A recording to replay in place of the wall clock and live input, empty to run normally. The application closes once the
+		 * recording has been replayed, logging a summary of the measured frame times. Replaying disables the main thread budget.
+		 * Must be set before the application is run.
+		 */
+		std::string replayFile;
+
+		/**
+		 * Whether or not to render while replaying, disable to benchmark updating alone
+		 */
+		bool replayRendering = true;
+
 		/**
 		 * Called when the application begins, just before the window is run.
 		 */
@@ -204,11 +322,13 @@ namespace Kale {
 		[[nodiscard]] size_t getNumUpdateThreads() const noexcept;
 
 		/**
-		 * Runs a given task on the main thread prior to rendering on any given frame, Can be called on any thread
+		 * Runs a given task on the main thread prior to rendering on any given frame, Can be called on any thread. Tasks pushed by one
+		 * thread, or otherwise pushed one after another, run in the order pushed. Tasks pushed concurrently by different threads have
+		 * no defined order.
 		 * @note Do not use reference based lambdas if anything referenced is at risk of being destroyed.
 		 * @param task A method which carries out any necessary task
 		 */
-		void runTaskOnMainThread(std::function<void()> task);
+		void runTaskOnMainThread(Task task);
 
 		/**
 		 * Gets the path to the assets folder
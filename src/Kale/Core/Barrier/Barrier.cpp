@@ -0,0 +1,98 @@
+/*
+   Copyright 2022 Rishi Challa
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+	   http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+#include "Barrier.hpp"
+
+#include <thread>
+#include <vector>
+#include <chrono>
+
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || defined(_M_IX86)
+#include <immintrin.h>
+#define KALE_CPU_RELAX() _mm_pause()
+#else
+#define KALE_CPU_RELAX() std::this_thread::yield()
+#endif
+
+using namespace Kale;
+
+/**
+ * Creates a new barrier
+ * @param parties The number of threads which must arrive before the barrier releases
+ * @param spinCount The number of times a waiting thread checks the sense before parking
+ */
+Barrier::Barrier(size_t parties, size_t spinCount) : parties(parties), spinCount(spinCount), remaining(parties), sense(false) {
+	// Empty Body
+}
+
+/**
+ * Arrives at the barrier and blocks until every party has arrived
+ */
+void Barrier::arriveAndWait() noexcept {
+
+	// The sense can't flip until this thread arrives, so reading it first is safe
+	bool localSense = !sense.load(std::memory_order_relaxed);
+
+	// The last thread to arrive resets the count and releases everyone else
+	if (remaining.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+		remaining.store(parties, std::memory_order_relaxed);
+		sense.store(localSense, std::memory_order_release);
+		sense.notify_all();
+		return;
+	}
+
+	// Spin briefly as the other threads are likely close behind
+	for (size_t i = 0; i < spinCount; i++) {
+		if (sense.load(std::memory_order_acquire) == localSense) return;
+		KALE_CPU_RELAX();
+	}
+
+	// Park until the sense flips
+	while (sense.load(std::memory_order_acquire) != localSense) sense.wait(!localSense, std::memory_order_acquire);
+}
+
+/**
+ * Gets the number of threads which must arrive before the barrier releases
+ * @returns The number of parties
+ */
+size_t Barrier::getParties() const noexcept {
+	return parties;
+}
+
+/**
+ * Measures the average latency of the barrier by repeatedly synchronizing the given number of threads
+ * @param numThreads The number of threads to synchronize
+ * @param iterations The number of phases to run
+ * @returns The average time in microseconds each phase took
+ */
+float Barrier::benchmark(size_t numThreads, size_t iterations) {
+	if (numThreads == 0 || iterations == 0) return 0.0f;
+
+	Barrier barrier(numThreads);
+	std::vector<std::thread> threads;
+	for (size_t i = 1; i < numThreads; i++) threads.emplace_back([&]() {
+		for (size_t j = 0; j <= iterations; j++) barrier.arriveAndWait();
+	});
+
+	// The first phase only lines the threads up so their startup isn't measured
+	barrier.arriveAndWait();
+	auto startTime = std::chrono::steady_clock::now();
+	for (size_t j = 0; j < iterations; j++) barrier.arriveAndWait();
+	auto endTime = std::chrono::steady_clock::now();
+
+	for (std::thread& thread : threads) thread.join();
+	return std::chrono::duration<float, std::micro>(endTime - startTime).count() / static_cast<float>(iterations);
+}
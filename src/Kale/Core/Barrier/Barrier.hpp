@@ -0,0 +1,89 @@
+/*
+   Copyright 2022 Rishi Challa
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+	   http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+
+namespace Kale {
+
+	/**
+	 * A reusable sense reversing barrier. Arriving threads spin on the shared sense for a short while before parking on it,
+	 * so phases which finish at roughly the same time never have to go through the kernel.
+	 */
+	class Barrier {
+	private:
+
+		/**
+		 * The number of threads which must arrive before the barrier releases
+		 */
+		const size_t parties;
+
+		/**
+		 * The number of times a waiting thread checks the sense before parking
+		 */
+		const size_t spinCount;
+
+		/**
+		 * The number of threads still to arrive in the current phase
+		 */
+		alignas(64) std::atomic<size_t> remaining;
+
+		/**
+		 * The shared sense, flipped by the last thread to arrive in each phase
+		 */
+		alignas(64) std::atomic<bool> sense;
+
+	public:
+
+		/**
+		 * Creates a new barrier
+		 * @param parties The number of threads which must arrive before the barrier releases
+		 * @param spinCount The number of times a waiting thread checks the sense before parking
+		 */
+		explicit Barrier(size_t parties, size_t spinCount = 4096);
+
+		/**
+		 * Barriers do not support copying
+		 */
+		Barrier(const Barrier& other) = delete;
+
+		/**
+		 * Barriers do not support copying
+		 */
+		void operator=(const Barrier& other) = delete;
+
+		/**
+		 * Arrives at the barrier and blocks until every party has arrived
+		 */
+		void arriveAndWait() noexcept;
+
+		/**
+		 * Gets the number of threads which must arrive before the barrier releases
+		 * @returns The number of parties
+		 */
+		size_t getParties() const noexcept;
+
+		/**
+		 * Measures the average latency of the barrier by repeatedly synchronizing the given number of threads
+		 * @param numThreads The number of threads to synchronize
+		 * @param iterations The number of phases to run
+		 * @returns The average time in microseconds each phase took
+		 */
+		static float benchmark(size_t numThreads, size_t iterations = 100000);
+	};
+}
@@ -0,0 +1,254 @@
+/*
+   Copyright 2022 Rishi Challa
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+	   http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+
+#pragma once
+
+#include <Kale/Math/Path/Path.hpp>
+#include <Kale/Math/Transform/Transform.hpp>
+
+#include <vector>
+#include <span>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <stdexcept>
+#include <cstring>
+#include <cstdint>
+#include <cstddef>
+
+namespace Kale {
+
+	/**
+	 * Writes values into the flat sections of a binary scene file. Values are written in the native byte order and aligned to
+	 * their natural alignment, arrays are aligned to 16 bytes so they can be read in place from a mapping of the file.
+	 */
+	class BinarySceneWriter {
+	private:
+
+		/**
+		 * The written bytes
+		 */
+		std::vector<uint8_t> data;
+
+	public:
+
+		/**
+		 * Pads the written bytes with zeros to a multiple of the alignment
+		 * @param alignment The alignment, must be a power of two
+		 */
+		void align(size_t alignment) {
+			data.resize((data.size() + alignment - 1) & ~(alignment - 1), 0);
+		}
+
+		/**
+		 * Writes a value
+		 * @param value The value to write, must be trivially copyable
+		 */
+		template <typename T> void write(const T& value) {
+			static_assert(std::is_trivially_copyable<T>::value, "Only trivially copyable values can be written to binary scenes");
+			align(alignof(T));
+			const uint8_t* bytes = reinterpret_cast<const uint8_t*>(&value);
+			data.insert(data.end(), bytes, bytes + sizeof(T));
+		}
+
+		/**
+		 * Writes an array of values preceded by its length
+		 * @param values The values to write, must be trivially copyable
+		 */
+		template <typename T> void writeArray(std::span<const T> values) {
+			static_assert(std::is_trivially_copyable<T>::value, "Only trivially copyable values can be written to binary scenes");
+			static_assert(alignof(T) <= 16, "Binary scene arrays are aligned to 16 bytes");
+			write(static_cast<uint64_t>(values.size()));
+			align(16);
+			const uint8_t* bytes = reinterpret_cast<const uint8_t*>(values.data());
+			data.insert(data.end(), bytes, bytes + values.size_bytes());
+		}
+
+		/**
+		 * Writes a string preceded by its length
+		 * @param string The string to write
+		 */
+		void writeString(std::string_view string) {
+			write(static_cast<uint64_t>(string.size()));
+			data.insert(data.end(), string.begin(), string.end());
+		}
+
+		/**
+		 * Appends the bytes of another writer, aligned to 16 bytes so the other writer's alignment is kept
+		 * @param other The writer to append
+		 */
+		void append(const BinarySceneWriter& other) {
+			align(16);
+			data.insert(data.end(), other.data.begin(), other.data.end());
+		}
+
+		/**
+		 * Gets the number of bytes written
+		 * @returns The number of bytes
+		 */
+		size_t size() const {
+			return data.size();
+		}
+
+		/**
+		 * Gets the written bytes
+		 * @returns The bytes
+		 */
+		const std::vector<uint8_t>& getData() const {
+			return data;
+		}
+	};
+
+	/**
+	 * Reads values from the flat sections of a binary scene file, arrays & strings are returned as views into the read memory
+	 */
+	class BinarySceneReader {
+	private:
+
+		/**
+		 * The start of the readable bytes, aligned to at least 16 bytes
+		 */
+		const uint8_t* begin;
+
+		/**
+		 * The position of the next value to read
+		 */
+		const uint8_t* position;
+
+		/**
+		 * The end of the readable bytes
+		 */
+		const uint8_t* end;
+
+		/**
+		 * Checks a number of bytes can be read from the current position
+		 * @param size The number of bytes
+		 * @throws If the bytes run past the end
+		 */
+		void require(size_t size) const {
+			if (static_cast<size_t>(end - position) < size) throw std::runtime_error("Binary scene ended unexpectedly");
+		}
+
+	public:
+
+		/**
+		 * Creates a reader over a range of bytes
+		 * @param data The bytes, must be aligned to at least 16 bytes
+		 * @param size The number of bytes
+		 */
+		BinarySceneReader(const uint8_t* data, size_t size) : begin(data), position(data), end(data + size) {
+			// Empty Body
+		}
+
+		/**
+		 * Skips to the next multiple of the alignment
+		 * @param alignment The alignment, must be a power of two
+		 */
+		void align(size_t alignment) {
+			size_t offset = static_cast<size_t>(position - begin);
+			size_t padding = ((offset + alignment - 1) & ~(alignment - 1)) - offset;
+			require(padding);
+			position += padding;
+		}
+
+		/**
+		 * Reads a value
+		 * @returns The value
+		 * @throws If the value runs past the end
+		 */
+		template <typename T> T read() {
+			static_assert(std::is_trivially_copyable<T>::value, "Only trivially copyable values can be read from binary scenes");
+			align(alignof(T));
+			require(sizeof(T));
+			T value;
+			std::memcpy(&value, position, sizeof(T));
+			position += sizeof(T);
+			return value;
+		}
+
+		/**
+		 * Reads an array of values in place
+		 * @returns A view of the values, valid as long as the read memory
+		 * @throws If the array runs past the end
+		 */
+		template <typename T> std::span<const T> readArray() {
+			static_assert(std::is_trivially_copyable<T>::value, "Only trivially copyable values can be read from binary scenes");
+			uint64_t count = read<uint64_t>();
+			align(16);
+			if (count > static_cast<uint64_t>(end - position) / sizeof(T)) throw std::runtime_error("Binary scene ended unexpectedly");
+			std::span<const T> values(reinterpret_cast<const T*>(position), static_cast<size_t>(count));
+			position += values.size_bytes();
+			return values;
+		}
+
+		/**
+		 * Reads a string in place
+		 * @returns A view of the string, valid as long as the read memory
+		 * @throws If the string runs past the end
+		 */
+		std::string_view readString() {
+			uint64_t length = read<uint64_t>();
+			if (length > static_cast<uint64_t>(end - position)) throw std::runtime_error("Binary scene ended unexpectedly");
+			std::string_view string(reinterpret_cast<const char*>(position), static_cast<size_t>(length));
+			position += length;
+			return string;
+		}
+
+		/**
+		 * Creates a reader over a section following the current position
+		 * @param offset The offset of the section from the current position, must keep the 16 byte alignment
+		 * @param size The size of the section
+		 * @returns The reader
+		 * @throws If the section runs past the end or isn't 16 byte aligned, as the section's reads align from its start
+		 */
+		BinarySceneReader section(uint64_t offset, uint64_t size) const {
+			uint64_t remaining = static_cast<uint64_t>(end - position);
+			if (offset > remaining || size > remaining - offset) throw std::runtime_error("Binary scene section out of range");
+			if ((static_cast<uint64_t>(position - begin) + offset) % 16 != 0) throw std::runtime_error("Binary scene section misaligned");
+			return BinarySceneReader(position + offset, static_cast<size_t>(size));
+		}
+	};
+
+	/**
+	 * Writes a transform to a binary scene
+	 */
+	inline void writeBinary(BinarySceneWriter& writer, const Transform& transform) {
+		writer.write(transform);
+	}
+
+	/**
+	 * Reads a transform from a binary scene
+	 */
+	inline void readBinary(BinarySceneReader& reader, Transform& transform) {
+		transform = reader.read<Transform>();
+	}
+
+	/**
+	 * Writes a path to a binary scene
+	 */
+	inline void writeBinary(BinarySceneWriter& writer, const Path& path) {
+		writer.writeArray<CubicBezier>(path.beziers);
+	}
+
+	/**
+	 * Reads a path from a binary scene, copying the beziers out in a single block
+	 */
+	inline void readBinary(BinarySceneReader& reader, Path& path) {
+		std::span<const CubicBezier> beziers = reader.readArray<CubicBezier>();
+		path.beziers.assign(beziers.begin(), beziers.end());
+	}
+}
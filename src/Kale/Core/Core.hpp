@@ -17,8 +17,22 @@
 #pragma once
 
 #include "Application/Application.hpp"
+#include "Barrier/Barrier.hpp"
+#include "BinaryScene/BinaryScene.hpp"
 #include "Events/Events.hpp"
+#include "FramePool/FramePool.hpp"
+#include "FrameRecorder/FrameRecorder.hpp"
+#include "JobSystem/JobSystem.hpp"
 #include "Logger/Logger.hpp"
+#include "MappedFile/MappedFile.hpp"
+#include "MPSCQueue/MPSCQueue.hpp"
 #include "Scene/Scene.hpp"
+#include "SceneLoader/SceneLoader.hpp"
+#include "SceneParser/SceneParser.hpp"
+#include "SlotMap/SlotMap.hpp"
+#include "Task/Task.hpp"
+#include "TimerWheel/TimerWheel.hpp"
+#include "ThreadPoolConfig/ThreadPoolConfig.hpp"
 #include "Tree/Tree.hpp"
 #include "Window/Window.hpp"
+#include "WorkStealingDeque/WorkStealingDeque.hpp"
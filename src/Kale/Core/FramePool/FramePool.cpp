@@ -0,0 +1,122 @@
+/*
+   Copyright 2022 Rishi Challa
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+	   http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+
+#include "FramePool.hpp"
+
+#include <new>
+
+using namespace Kale;
+
+std::mutex FramePool::mutex;
+std::array<FramePool::FreeBlock*, FramePool::numSizeClasses> FramePool::sharedBlocks{};
+thread_local FramePool::ThreadCache FramePool::cache;
+
+/**
+ * Returns the thread's free blocks to the shared free lists
+ */
+FramePool::ThreadCache::~ThreadCache() {
+	std::lock_guard lock(mutex);
+	for (size_t sizeClass = 0; sizeClass < numSizeClasses; sizeClass++) {
+		while (blocks[sizeClass] != nullptr) {
+			FreeBlock* block = blocks[sizeClass];
+			blocks[sizeClass] = block->next;
+			block->next = sharedBlocks[sizeClass];
+			sharedBlocks[sizeClass] = block;
+		}
+	}
+}
+
+/**
+ * Moves a batch of blocks from the shared free list to this thread's free list, allocating new blocks if there are none
+ * @param sizeClass The size class to refill
+ */
+void FramePool::refill(size_t sizeClass) {
+	{
+		std::lock_guard lock(mutex);
+		while (cache.counts[sizeClass] < batchSize && sharedBlocks[sizeClass] != nullptr) {
+			FreeBlock* block = sharedBlocks[sizeClass];
+			sharedBlocks[sizeClass] = block->next;
+			block->next = cache.blocks[sizeClass];
+			cache.blocks[sizeClass] = block;
+			cache.counts[sizeClass]++;
+		}
+	}
+	if (cache.blocks[sizeClass] != nullptr) return;
+
+	// Carve a new batch out of a single heap allocation
+	size_t blockSize = (sizeClass + 1) * sizeStep;
+	char* memory = static_cast<char*>(::operator new(blockSize * batchSize));
+	for (size_t i = 0; i < batchSize; i++) {
+		FreeBlock* block = reinterpret_cast<FreeBlock*>(memory + i * blockSize);
+		block->next = cache.blocks[sizeClass];
+		cache.blocks[sizeClass] = block;
+	}
+	cache.counts[sizeClass] = batchSize;
+}
+
+/**
+ * Moves a batch of blocks from this thread's free list to the shared free list
+ * @param sizeClass The size class to release
+ */
+void FramePool::release(size_t sizeClass) {
+	std::lock_guard lock(mutex);
+	for (size_t i = 0; i < batchSize; i++) {
+		FreeBlock* block = cache.blocks[sizeClass];
+		cache.blocks[sizeClass] = block->next;
+		block->next = sharedBlocks[sizeClass];
+		sharedBlocks[sizeClass] = block;
+	}
+	cache.counts[sizeClass] -= batchSize;
+}
+
+/**
+ * Allocates a block
+ * @param size The size of the block in bytes
+ * @returns The block, aligned for any fundamental type
+ */
+void* FramePool::allocate(size_t size) {
+	size_t sizeClass = (size + sizeStep - 1) / sizeStep - 1;
+	if (size == 0) sizeClass = 0;
+	if (sizeClass >= numSizeClasses) return ::operator new(size);
+
+	if (cache.blocks[sizeClass] == nullptr) refill(sizeClass);
+	FreeBlock* block = cache.blocks[sizeClass];
+	cache.blocks[sizeClass] = block->next;
+	cache.counts[sizeClass]--;
+	return block;
+}
+
+/**
+ * Frees a block
+ * @param block The block to free
+ * @param size The size the block was allocated with
+ */
+void FramePool::deallocate(void* block, size_t size) noexcept {
+	size_t sizeClass = (size + sizeStep - 1) / sizeStep - 1;
+	if (size == 0) sizeClass = 0;
+	if (sizeClass >= numSizeClasses) {
+		::operator delete(block);
+		return;
+	}
+
+	FreeBlock* freeBlock = static_cast<FreeBlock*>(block);
+	freeBlock->next = cache.blocks[sizeClass];
+	cache.blocks[sizeClass] = freeBlock;
+
+	// Hand a batch back to the other threads once this thread holds more than it is likely to reuse
+	if (++cache.counts[sizeClass] > batchSize * 2) release(sizeClass);
+}
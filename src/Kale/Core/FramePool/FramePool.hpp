@@ -0,0 +1,124 @@
+/*
+   Copyright 2022 Rishi Challa
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+	   http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+
+#pragma once
+
+#include <array>
+#include <mutex>
+#include <cstddef>
+
+namespace Kale {
+
+	/**
+	 * A pooled allocator for short lived, frequently created blocks such as coroutine frames. Blocks are grouped into size classes
+	 * and recycled through per thread free lists, which exchange batches with a shared free list so blocks freed on another thread
+	 * are reused rather than returned to the heap. Pooled memory is kept for the lifetime of the program.
+	 */
+	class FramePool {
+	private:
+
+		/**
+		 * The difference in size between consecutive size classes in bytes
+		 */
+		static constexpr size_t sizeStep = 64;
+
+		/**
+		 * The number of size classes, blocks larger than sizeStep * numSizeClasses bytes are allocated on the heap
+		 */
+		static constexpr size_t numSizeClasses = 16;
+
+		/**
+		 * The number of blocks moved between a thread's free list and the shared free list at a time
+		 */
+		static constexpr size_t batchSize = 32;
+
+		/**
+		 * A free block, linked into a free list
+		 */
+		struct FreeBlock {
+
+			/**
+			 * The next free block in the list
+			 */
+			FreeBlock* next;
+		};
+
+		/**
+		 * The free lists of a single thread
+		 */
+		struct ThreadCache {
+
+			/**
+			 * The first free block of each size class
+			 */
+			std::array<FreeBlock*, numSizeClasses> blocks{};
+
+			/**
+			 * The number of free blocks of each size class
+			 */
+			std::array<size_t, numSizeClasses> counts{};
+
+			/**
+			 * Returns the thread's free blocks to the shared free lists
+			 */
+			~ThreadCache();
+		};
+
+		/**
+		 * The mutex used for accessing the shared free lists
+		 */
+		static std::mutex mutex;
+
+		/**
+		 * The first free block of each size class shared between threads
+		 */
+		static std::array<FreeBlock*, numSizeClasses> sharedBlocks;
+
+		/**
+		 * The free lists of the current thread
+		 */
+		static thread_local ThreadCache cache;
+
+		/**
+		 * Moves a batch of blocks from the shared free list to this thread's free list, allocating new blocks if there are none
+		 * @param sizeClass The size class to refill
+		 */
+		static void refill(size_t sizeClass);
+
+		/**
+		 * Moves a batch of blocks from this thread's free list to the shared free list
+		 * @param sizeClass The size class to release
+		 */
+		static void release(size_t sizeClass);
+
+	public:
+
+		/**
+		 * Allocates a block
+		 * @param size The size of the block in bytes
+		 * @returns The block, aligned for any fundamental type
+		 */
+		static void* allocate(size_t size);
+
+		/**
+		 * Frees a block
+		 * @param block The block to free
+		 * @param size The size the block was allocated with
+		 */
+		static void deallocate(void* block, size_t size) noexcept;
+	};
+}
@@ -0,0 +1,539 @@
+/*
+   Copyright 2022 Rishi Challa
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+	   http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+
+#include "FrameRecorder.hpp"
+
+#include <Kale/Core/Logger/Logger.hpp>
+
+#include <fstream>
+#include <iterator>
+#include <algorithm>
+#include <stdexcept>
+#include <cstring>
+
+using namespace Kale;
+
+/**
+ * The bytes every recording starts with
+ */
+static constexpr char recordingMagic[4] = {'K', 'R', 'E', 'C'};
+
+/**
+ * The version of the recording format, incremented whenever the format changes
+ */
+static constexpr uint32_t recordingVersion = 1;
+
+/**
+ * Hashes a node name with FNV-1a, so hashes stay the same across builds and platforms
+ * @param name The name to hash
+ * @returns The hash
+ */
+static uint64_t hashName(const std::string& name) {
+	uint64_t hash = 14695981039346656037ull;
+	for (char c : name) {
+		hash ^= static_cast<uint8_t>(c);
+		hash *= 1099511628211ull;
+	}
+	return hash;
+}
+
+/**
+ * Counts a node being added
+ * @param name The name of the node
+ */
+void FrameRecorder::StructureChange::addNode(const std::string& name) {
+	nodesAdded++;
+	nameHash += hashName(name);
+}
+
+/**
+ * Counts a node being removed
+ * @param name The name of the node
+ */
+void FrameRecorder::StructureChange::removeNode(const std::string& name) {
+	nodesRemoved++;
+	nameHash += hashName(name) * 31;
+}
+
+/**
+ * Creates a frame recorder which neither records nor replays
+ */
+FrameRecorder::FrameRecorder() : readPosition(0), replaying(false), frame(0), divergedUpdates(0) {
+	// Empty Body
+}
+
+/**
+ * Appends a value to the recorded data
+ * @param value The value to write
+ */
+template <typename T> void FrameRecorder::write(const T& value) {
+	const uint8_t* bytes = reinterpret_cast<const uint8_t*>(&value);
+	data.insert(data.end(), bytes, bytes + sizeof(T));
+}
+
+/**
+ * Reads the next value from the recorded data
+ * @returns The value read
+ * @throws If the recording ends before the value
+ */
+template <typename T> T FrameRecorder::read() {
+	if (data.size() - readPosition < sizeof(T)) throw std::runtime_error("Recording ended unexpectedly");
+	T value;
+	std::memcpy(&value, data.data() + readPosition, sizeof(T));
+	readPosition += sizeof(T);
+	return value;
+}
+
+/**
+ * Appends an event record to the recorded data
+ * @param record The type of event
+ * @param values The values of the event
+ */
+template <typename... Args> void FrameRecorder::writeEvent(Record record, const Args&... values) {
+	if (recordingFile.empty()) return;
+	write(record);
+	(write(values), ...);
+}
+
+/**
+ * Starts recording, the recording is written to the file once finished
+ * @param filename The path of the file to write to
+ */
+void FrameRecorder::startRecording(const std::string& filename) {
+	recordingFile = filename;
+	replaying = false;
+	frame = 0;
+	data.clear();
+	data.insert(data.end(), std::begin(recordingMagic), std::end(recordingMagic));
+	write(recordingVersion);
+}
+
+/**
+ * Loads a recording and starts replaying it
+ * @param filename The path of the file to replay
+ * @throws If the file could not be read or is not a recording
+ */
+void FrameRecorder::startReplay(const std::string& filename) {
+	std::ifstream file(filename, std::ios::binary);
+	if (!file) throw std::runtime_error("Unable to open recording " + filename);
+	data.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+
+	readPosition = 0;
+	if (data.size() < sizeof(recordingMagic) || !std::equal(std::begin(recordingMagic), std::end(recordingMagic), data.begin()))
+		throw std::runtime_error(filename + " is not a recording");
+	readPosition = sizeof(recordingMagic);
+	if (read<uint32_t>() != recordingVersion) throw std::runtime_error(filename + " was recorded with an unsupported version");
+
+	recordingFile.clear();
+	replaying = true;
+	frame = 0;
+	divergedUpdates = 0;
+	replayedFrameTimes.clear();
+}
+
+/**
+ * Checks whether or not frames are being recorded
+ * @returns Whether or not frames are being recorded
+ */
+bool FrameRecorder::isRecording() const {
+	return !recordingFile.empty();
+}
+
+/**
+ * Checks whether or not a recording is being replayed
+ * @returns Whether or not a recording is being replayed
+ */
+bool FrameRecorder::isReplaying() const {
+	return replaying;
+}
+
+/**
+ * Records the end of a frame's events along with the frame time, called after the window's events have been dispatched
+ * @param frameTime The time in microseconds the last frame took
+ */
+void FrameRecorder::recordFrame(float frameTime) {
+	if (recordingFile.empty()) return;
+	write(Record::Frame);
+	write(frameTime);
+	frame++;
+}
+
+/**
+ * Records the nodes a scene began & ended within an update, unchanged updates are not written
+ * @param update The index of the update within the current frame
+ * @param change The structure change
+ */
+void FrameRecorder::recordStructureChange(uint32_t update, const StructureChange& change) {
+	if (recordingFile.empty() || change == StructureChange()) return;
+	write(Record::StructureChange);
+	write(update);
+	write(change.nodesAdded);
+	write(change.nodesRemoved);
+	write(change.nameHash);
+}
+
+/**
+ * Dispatches the next frame's recorded events to the given event handlers
+ * @param handlers The event handlers to dispatch to
+ * @param frameTime Set to the recorded frame time
+ * @returns False once the recording has been fully replayed
+ */
+bool FrameRecorder::replayFrame(const std::list<EventHandler*>& handlers, float& frameTime) {
+	if (!replaying) return false;
+
+	// Calls an event on every handler
+	const auto dispatch = [&](auto event) {
+		for (EventHandler* handler : handlers) event(*handler);
+	};
+
+	// Reads a two dimensional vector
+	const auto readVector = [&]() -> Vector2f {
+		float x = read<float>();
+		return Vector2f(x, read<float>());
+	};
+
+	while (readPosition < data.size()) {
+		Record record = read<Record>();
+		switch (record) {
+			case Record::Frame:
+				frameTime = read<float>();
+				frame++;
+				return true;
+			case Record::StructureChange:
+				// Left behind by updates the replay didn't run, skip over it
+				readPosition += sizeof(uint32_t) * 3 + sizeof(uint64_t);
+				divergedUpdates++;
+				break;
+			case Record::WindowResize: {
+				uint32_t oldX = read<uint32_t>(), oldY = read<uint32_t>(), newX = read<uint32_t>(), newY = read<uint32_t>();
+				dispatch([&](EventHandler& handler) { handler.onWindowResize(Vector2ui(oldX, oldY), Vector2ui(newX, newY)); });
+				break;
+			}
+			case Record::WindowLostFocus: dispatch([](EventHandler& handler) { handler.onWindowLostFocus(); }); break;
+			case Record::WindowGainedFocus: dispatch([](EventHandler& handler) { handler.onWindowGainedFocus(); }); break;
+			case Record::ControllerConnect: {
+				uint32_t controller = read<uint32_t>();
+				dispatch([&](EventHandler& handler) { handler.onControllerConnect(controller); });
+				break;
+			}
+			case Record::ControllerDisconnect: {
+				uint32_t controller = read<uint32_t>();
+				dispatch([&](EventHandler& handler) { handler.onControllerDisconnect(controller); });
+				break;
+			}
+			case Record::ControllerButtonPress: {
+				uint32_t controller = read<uint32_t>();
+				ControllerButton button = static_cast<ControllerButton>(read<uint8_t>());
+				dispatch([&](EventHandler& handler) { handler.onControllerButtonPress(controller, button); });
+				break;
+			}
+			case Record::ControllerButtonRelease: {
+				uint32_t controller = read<uint32_t>();
+				ControllerButton button = static_cast<ControllerButton>(read<uint8_t>());
+				dispatch([&](EventHandler& handler) { handler.onControllerButtonRelease(controller, button); });
+				break;
+			}
+			case Record::ControllerHandle: {
+				uint32_t controller = read<uint32_t>();
+				ControllerAxis axis = static_cast<ControllerAxis>(read<uint8_t>());
+				float position = read<float>();
+				dispatch([&](EventHandler& handler) { handler.onControllerHandle(controller, axis, position); });
+				break;
+			}
+			case Record::ControllerJoystick: {
+				uint32_t controller = read<uint32_t>();
+				ControllerAxis axis = static_cast<ControllerAxis>(read<uint8_t>());
+				Vector2f position = readVector();
+				dispatch([&](EventHandler& handler) { handler.onControllerJoystick(controller, axis, position); });
+				break;
+			}
+			case Record::KeyPress: {
+				Key key = static_cast<Key>(read<uint8_t>());
+				dispatch([&](EventHandler& handler) { handler.onKeyPress(key); });
+				break;
+			}
+			case Record::KeyRelease: {
+				Key key = static_cast<Key>(read<uint8_t>());
+				dispatch([&](EventHandler& handler) { handler.onKeyRelease(key); });
+				break;
+			}
+			case Record::MouseMove: {
+				Vector2f pos = readVector();
+				dispatch([&](EventHandler& handler) { handler.onMouseMove(pos); });
+				break;
+			}
+			case Record::MouseScroll: {
+				float scroll = read<float>();
+				dispatch([&](EventHandler& handler) { handler.onMouseScroll(scroll); });
+				break;
+			}
+			case Record::LeftClick: dispatch([](EventHandler& handler) { handler.onLeftClick(); }); break;
+			case Record::MiddleClick: dispatch([](EventHandler& handler) { handler.onMiddleClick(); }); break;
+			case Record::RightClick: dispatch([](EventHandler& handler) { handler.onRightClick(); }); break;
+			case Record::LeftClickRelease: dispatch([](EventHandler& handler) { handler.onLeftClickRelease(); }); break;
+			case Record::MiddleClickRelease: dispatch([](EventHandler& handler) { handler.onMiddleClickRelease(); }); break;
+			case Record::RightClickRelease: dispatch([](EventHandler& handler) { handler.onRightClickRelease(); }); break;
+			case Record::TouchBegin: {
+				uint32_t touch = read<uint32_t>();
+				Vector2f pos = readVector();
+				dispatch([&](EventHandler& handler) { handler.onTouchBegin(touch, pos); });
+				break;
+			}
+			case Record::TouchMove: {
+				uint32_t touch = read<uint32_t>();
+				Vector2f pos = readVector();
+				dispatch([&](EventHandler& handler) { handler.onTouchMove(touch, pos); });
+				break;
+			}
+			case Record::TouchEnd: {
+				uint32_t touch = read<uint32_t>();
+				dispatch([&](EventHandler& handler) { handler.onTouchEnd(touch); });
+				break;
+			}
+			default:
+				throw std::runtime_error("Recording is corrupt");
+		}
+	}
+
+	return false;
+}
+
+/**
+ * Compares the nodes a scene began & ended within an update to the recording, logging a warning if they differ
+ * @param update The index of the update within the current frame
+ * @param change The structure change
+ */
+void FrameRecorder::checkStructureChange(uint32_t update, const StructureChange& change) {
+	if (!replaying) return;
+
+	// Unchanged updates aren't recorded, so only read the record if it belongs to this update
+	StructureChange recorded;
+	if (data.size() - readPosition >= sizeof(Record) + sizeof(uint32_t) &&
+		static_cast<Record>(data[readPosition]) == Record::StructureChange) {
+		size_t position = readPosition;
+		readPosition += sizeof(Record);
+		if (read<uint32_t>() == update) {
+			recorded.nodesAdded = read<uint32_t>();
+			recorded.nodesRemoved = read<uint32_t>();
+			recorded.nameHash = read<uint64_t>();
+		}
+		else readPosition = position;
+	}
+
+	if (recorded == change) return;
+	divergedUpdates++;
+	console.warn("Replay diverged from the recording on frame " + std::to_string(frame) + ", " + std::to_string(change.nodesAdded) +
+		" nodes added & " + std::to_string(change.nodesRemoved) + " removed where " + std::to_string(recorded.nodesAdded) +
+		" & " + std::to_string(recorded.nodesRemoved) + " were recorded");
+}
+
+/**
+ * Stores the measured time of a replayed frame
+ * @param time The time in microseconds the frame took to update & render
+ */
+void FrameRecorder::measureReplayedFrame(float time) {
+	if (replaying) replayedFrameTimes.push_back(time);
+}
+
+/**
+ * Finishes recording or replaying, writing out the recording or logging a summary of the replayed frame times
+ */
+void FrameRecorder::finish() {
+	if (!recordingFile.empty()) {
+		std::ofstream file(recordingFile, std::ios::binary);
+		file.write(reinterpret_cast<const char*>(data.data()), static_cast<std::streamsize>(data.size()));
+		if (!file) console.error("Unable to write recording " + recordingFile);
+		else console.info("Recorded " + std::to_string(frame) + " frames to " + recordingFile);
+		recordingFile.clear();
+	}
+
+	if (replaying) {
+		replaying = false;
+		if (replayedFrameTimes.empty()) return;
+
+		// Summarize the frame times, percentiles show hitches which averages hide
+		std::vector<float> sorted = replayedFrameTimes;
+		std::sort(sorted.begin(), sorted.end());
+		double total = 0.0;
+		for (float time : sorted) total += time;
+		const auto percentile = [&](double p) -> float {
+			return sorted[std::min(sorted.size() - 1, static_cast<size_t>(p * static_cast<double>(sorted.size())))];
+		};
+		console.info("Replayed " + std::to_string(sorted.size()) + " frames in " + std::to_string(total / 1000.0) + "ms - mean " +
+			std::to_string(total / static_cast<double>(sorted.size())) + "us, median " + std::to_string(percentile(0.5)) + "us, 99th " +
+			std::to_string(percentile(0.99)) + "us, max " + std::to_string(sorted.back()) + "us, " + std::to_string(divergedUpdates) +
+			" diverged updates");
+	}
+
+	data.clear();
+	data.shrink_to_fit();
+}
+
+/**
+ * Called when the event is fired
+ */
+void FrameRecorder::onWindowResize(Vector2ui oldSize, Vector2ui newSize) {
+	writeEvent(Record::WindowResize, static_cast<uint32_t>(oldSize.x), static_cast<uint32_t>(oldSize.y), static_cast<uint32_t>(newSize.x),
+		static_cast<uint32_t>(newSize.y));
+}
+
+/**
+ * Called when the event is fired
+ */
+void FrameRecorder::onWindowLostFocus() {
+	writeEvent(Record::WindowLostFocus);
+}
+
+/**
+ * Called when the event is fired
+ */
+void FrameRecorder::onWindowGainedFocus() {
+	writeEvent(Record::WindowGainedFocus);
+}
+
+/**
+ * Called when the event is fired
+ */
+void FrameRecorder::onControllerConnect(unsigned int controller) {
+	writeEvent(Record::ControllerConnect, static_cast<uint32_t>(controller));
+}
+
+/**
+ * Called when the event is fired
+ */
+void FrameRecorder::onControllerDisconnect(unsigned int controller) {
+	writeEvent(Record::ControllerDisconnect, static_cast<uint32_t>(controller));
+}
+
+/**
+ * Called when the event is fired
+ */
+void FrameRecorder::onControllerButtonPress(unsigned int controller, ControllerButton button) {
+	writeEvent(Record::ControllerButtonPress, static_cast<uint32_t>(controller), static_cast<uint8_t>(button));
+}
+
+/**
+ * Called when the event is fired
+ */
+void FrameRecorder::onControllerButtonRelease(unsigned int controller, ControllerButton button) {
+	writeEvent(Record::ControllerButtonRelease, static_cast<uint32_t>(controller), static_cast<uint8_t>(button));
+}
+
+/**
+ * Called when the event is fired
+ */
+void FrameRecorder::onControllerHandle(unsigned int controller, ControllerAxis handle, float position) {
+	writeEvent(Record::ControllerHandle, static_cast<uint32_t>(controller), static_cast<uint8_t>(handle), position);
+}
+
+/**
+ * Called when the event is fired
+ */
+void FrameRecorder::onControllerJoystick(unsigned int controller, ControllerAxis joystick, Vector2f position) {
+	writeEvent(Record::ControllerJoystick, static_cast<uint32_t>(controller), static_cast<uint8_t>(joystick), position.x, position.y);
+}
+
+/**
+ * Called when the event is fired
+ */
+void FrameRecorder::onKeyPress(Key key) {
+	writeEvent(Record::KeyPress, static_cast<uint8_t>(key));
+}
+
+/**
+ * Called when the event is fired
+ */
+void FrameRecorder::onKeyRelease(Key key) {
+	writeEvent(Record::KeyRelease, static_cast<uint8_t>(key));
+}
+
+/**
+ * Called when the event is fired
+ */
+void FrameRecorder::onMouseMove(Vector2f pos) {
+	writeEvent(Record::MouseMove, pos.x, pos.y);
+}
+
+/**
+ * Called when the event is fired
+ */
+void FrameRecorder::onMouseScroll(float scroll) {
+	writeEvent(Record::MouseScroll, scroll);
+}
+
+/**
+ * Called when the event is fired
+ */
+void FrameRecorder::onLeftClick() {
+	writeEvent(Record::LeftClick);
+}
+
+/**
+ * Called when the event is fired
+ */
+void FrameRecorder::onMiddleClick() {
+	writeEvent(Record::MiddleClick);
+}
+
+/**
+ * Called when the event is fired
+ */
+void FrameRecorder::onRightClick() {
+	writeEvent(Record::RightClick);
+}
+
+/**
+ * Called when the event is fired
+ */
+void FrameRecorder::onLeftClickRelease() {
+	writeEvent(Record::LeftClickRelease);
+}
+
+/**
+ * Called when the event is fired
+ */
+void FrameRecorder::onMiddleClickRelease() {
+	writeEvent(Record::MiddleClickRelease);
+}
+
+/**
+ * Called when the event is fired
+ */
+void FrameRecorder::onRightClickRelease() {
+	writeEvent(Record::RightClickRelease);
+}
+
+/**
+ * Called when the event is fired
+ */
+void FrameRecorder::onTouchBegin(unsigned int touch, Vector2f pos) {
+	writeEvent(Record::TouchBegin, static_cast<uint32_t>(touch), pos.x, pos.y);
+}
+
+/**
+ * Called when the event is fired
+ */
+void FrameRecorder::onTouchMove(unsigned int touch, Vector2f pos) {
+	writeEvent(Record::TouchMove, static_cast<uint32_t>(touch), pos.x, pos.y);
+}
+
+/**
+ * Called when the event is fired
+ */
+void FrameRecorder::onTouchEnd(unsigned int touch) {
+	writeEvent(Record::TouchEnd, static_cast<uint32_t>(touch));
+}
@@ -0,0 +1,331 @@
+/*
+   Copyright 2022 Rishi Challa
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+	   http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+
+#pragma once
+
+#include <Kale/Core/Events/Events.hpp>
+
+#include <string>
+#include <vector>
+#include <list>
+#include <cstdint>
+#include <cstddef>
+
+namespace Kale {
+
+	/**
+	 * Records the frame times, input events and node structure changes of a run to a compact binary file, and replays them
+	 * frame by frame so the same workload can be benchmarked repeatedly. Recording receives events as a window event handler,
+	 * replaying dispatches the recorded events to the window's event handlers in place of live input. Files use the native
+	 * byte order so are meant to be replayed on the machine architecture they were recorded on.
+	 */
+	class FrameRecorder : public EventHandler {
+	public:
+
+		/**
+		 * The nodes a scene began & ended within a single update along with an order independent hash of their names, recorded so
+		 * replays can be checked for diverging from the recorded run
+		 */
+		struct StructureChange {
+
+			/**
+			 * The number of nodes added
+			 */
+			uint32_t nodesAdded = 0;
+
+			/**
+			 * The number of nodes removed
+			 */
+			uint32_t nodesRemoved = 0;
+
+			/**
+			 * The sum of the hashes of the added & removed node names
+			 */
+			uint64_t nameHash = 0;
+
+			/**
+			 * Counts a node being added
+			 * @param name The name of the node
+			 */
+			void addNode(const std::string& name);
+
+			/**
+			 * Counts a node being removed
+			 * @param name The name of the node
+			 */
+			void removeNode(const std::string& name);
+
+			/**
+			 * Compares two structure changes
+			 * @param other The structure change to compare to
+			 * @returns Whether or not the changes are equal
+			 */
+			bool operator==(const StructureChange& other) const = default;
+		};
+
+	private:
+
+		/**
+		 * The type of each record within a recording, every frame is written as its events followed by the frame record and the
+		 * structure changes of its updates
+		 */
+		enum class Record : uint8_t {
+			Frame, StructureChange,
+			WindowResize, WindowLostFocus, WindowGainedFocus,
+			ControllerConnect, ControllerDisconnect, ControllerButtonPress, ControllerButtonRelease, ControllerHandle,
+			ControllerJoystick, KeyPress, KeyRelease, MouseMove, MouseScroll,
+			LeftClick, MiddleClick, RightClick, LeftClickRelease, MiddleClickRelease, RightClickRelease,
+			TouchBegin, TouchMove, TouchEnd
+		};
+
+		/**
+		 * The recorded data, written out once recording finishes or read in full when replaying
+		 */
+		std::vector<uint8_t> data;
+
+		/**
+		 * The position of the next record to read when replaying
+		 */
+		size_t readPosition;
+
+		/**
+		 * The file to write the recording to, empty when not recording
+		 */
+		std::string recordingFile;
+
+		/**
+		 * Whether or not a recording is being replayed
+		 */
+		bool replaying;
+
+		/**
+		 * The number of frames recorded or replayed so far
+		 */
+		size_t frame;
+
+		/**
+		 * The number of updates replayed whose structure changes did not match the recording
+		 */
+		size_t divergedUpdates;
+
+		/**
+		 * The measured time in microseconds of every replayed frame, summarized once the replay finishes
+		 */
+		std::vector<float> replayedFrameTimes;
+
+		/**
+		 * Appends a value to the recorded data
+		 * @param value The value to write
+		 */
+		template <typename T> void write(const T& value);
+
+		/**
+		 * Reads the next value from the recorded data
+		 * @returns The value read
+		 * @throws If the recording ends before the value
+		 */
+		template <typename T> T read();
+
+		/**
+		 * Appends an event record to the recorded data
+		 * @param record The type of event
+		 * @param values The values of the event
+		 */
+		template <typename... Args> void writeEvent(Record record, const Args&... values);
+
+	public:
+
+		/**
+		 * Creates a frame recorder which neither records nor replays
+		 */
+		FrameRecorder();
+
+		/**
+		 * Starts recording, the recording is written to the file once finished
+		 * @param filename The path of the file to write to
+		 */
+		void startRecording(const std::string& filename);
+
+		/**
+		 * Loads a recording and starts replaying it
+		 * @param filename The path of the file to replay
+		 * @throws If the file could not be read or is not a recording
+		 */
+		void startReplay(const std::string& filename);
+
+		/**
+		 * Checks whether or not frames are being recorded
+		 * @returns Whether or not frames are being recorded
+		 */
+		bool isRecording() const;
+
+		/**
+		 * Checks whether or not a recording is being replayed
+		 * @returns Whether or not a recording is being replayed
+		 */
+		bool isReplaying() const;
+
+		/**
+		 * Records the end of a frame's events along with the frame time, called after the window's events have been dispatched
+		 * @param frameTime The time in microseconds the last frame took
+		 */
+		void recordFrame(float frameTime);
+
+		/**
+		 * Records the nodes a scene began & ended within an update, unchanged updates are not written
+		 * @param update The index of the update within the current frame
+		 * @param change The structure change
+		 */
+		void recordStructureChange(uint32_t update, const StructureChange& change);
+
+		/**
+		 * Dispatches the next frame's recorded events to the given event handlers
+		 * @param handlers The event handlers to dispatch to
+		 * @param frameTime Set to the recorded frame time
+		 * @returns False once the recording has been fully replayed
+		 */
+		bool replayFrame(const std::list<EventHandler*>& handlers, float& frameTime);
+
+		/**
+		 * Compares the nodes a scene began & ended within an update to the recording, logging a warning if they differ
+		 * @param update The index of the update within the current frame
+		 * @param change The structure change
+		 */
+		void checkStructureChange(uint32_t update, const StructureChange& change);
+
+		/**
+		 * Stores the measured time of a replayed frame
+		 * @param time The time in microseconds the frame took to update & render
+		 */
+		void measureReplayedFrame(float time);
+
+		/**
+		 * Finishes recording or replaying, writing out the recording or logging a summary of the replayed frame times
+		 */
+		void finish();
+
+		/**
+		 * Called when the event is fired
+		 */
+		void onWindowResize(Vector2ui oldSize, Vector2ui newSize) override;
+
+		/**
+		 * Called when the event is fired
+		 */
+		void onWindowLostFocus() override;
+
+		/**
+		 * Called when the event is fired
+		 */
+		void onWindowGainedFocus() override;
+
+		/**
+		 * Called when the event is fired
+		 */
+		void onControllerConnect(unsigned int controller) override;
+
+		/**
+		 * Called when the event is fired
+		 */
+		void onControllerDisconnect(unsigned int controller) override;
+
+		/**
+		 * Called when the event is fired
+		 */
+		void onControllerButtonPress(unsigned int controller, ControllerButton button) override;
+
+		/**
+		 * Called when the event is fired
+		 */
+		void onControllerButtonRelease(unsigned int controller, ControllerButton button) override;
+
+		/**
+		 * Called when the event is fired
+		 */
+		void onControllerHandle(unsigned int controller, ControllerAxis handle, float position) override;
+
+		/**
+		 * Called when the event is fired
+		 */
+		void onControllerJoystick(unsigned int controller, ControllerAxis joystick, Vector2f position) override;
+
+		/**
+		 * Called when the event is fired
+		 */
+		void onKeyPress(Key key) override;
+
+		/**
+		 * Called when the event is fired
+		 */
+		void onKeyRelease(Key key) override;
+
+		/**
+		 * Called when the event is fired
+		 */
+		void onMouseMove(Vector2f pos) override;
+
+		/**
+		 * Called when the event is fired
+		 */
+		void onMouseScroll(float scroll) override;
+
+		/**
+		 * Called when the event is fired
+		 */
+		void onLeftClick() override;
+
+		/**
+		 * Called when the event is fired
+		 */
+		void onMiddleClick() override;
+
+		/**
+		 * Called when the event is fired
+		 */
+		void onRightClick() override;
+
+		/**
+		 * Called when the event is fired
+		 */
+		void onLeftClickRelease() override;
+
+		/**
+		 * Called when the event is fired
+		 */
+		void onMiddleClickRelease() override;
+
+		/**
+		 * Called when the event is fired
+		 */
+		void onRightClickRelease() override;
+
+		/**
+		 * Called when the event is fired
+		 */
+		void onTouchBegin(unsigned int touch, Vector2f pos) override;
+
+		/**
+		 * Called when the event is fired
+		 */
+		void onTouchMove(unsigned int touch, Vector2f pos) override;
+
+		/**
+		 * Called when the event is fired
+		 */
+		void onTouchEnd(unsigned int touch) override;
+	};
+}
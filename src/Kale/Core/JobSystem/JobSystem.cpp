@@ -0,0 +1,164 @@
+/*
+   Copyright 2022 Rishi Challa
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+	   http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+#include "JobSystem.hpp"
+
+#include <thread>
+#include <algorithm>
+
+using namespace Kale;
+
+/**
+ * Creates a new job system
+ * @param numThreads The number of update threads sharing the job system
+ * @param capacity The number of jobs each thread can hold pending, jobs spawned beyond this are run immediately
+ */
+JobSystem::JobSystem(size_t numThreads, size_t capacity) {
+	for (size_t i = 0; i < numThreads; i++) queues.push_back(std::make_unique<WorkStealingDeque<Job*>>(capacity));
+}
+
+/**
+ * Sets the update thread index of the calling thread, called by the scene at the start of each update
+ * @param threadNum The index of the update thread
+ */
+void JobSystem::setCurrentThread(size_t threadNum) {
+	currentThread = threadNum;
+}
+
+/**
+ * Runs a job & marks it as complete within its group
+ * @param job The job to run
+ */
+void JobSystem::runJob(Job& job) {
+	TaskGroup& group = *job.group;
+	try {
+		job.task();
+	}
+	catch (...) {
+		std::lock_guard guard(group.exceptionMutex);
+		if (group.exception == nullptr) group.exception = std::current_exception();
+	}
+	group.pending.fetch_sub(1, std::memory_order_release);
+}
+
+/**
+ * Pushes a job to the calling thread's deque, running it immediately if the calling thread is not an update thread or the
+ * deque is full
+ * @param job The job to push
+ */
+void JobSystem::push(Job& job) {
+	if (currentThread < queues.size() && queues[currentThread]->push(&job)) return;
+	runJob(job);
+}
+
+/**
+ * Runs a single pending job, taken from the calling thread's deque if possible and stolen from another thread otherwise
+ * @returns False if no job was found
+ */
+bool JobSystem::runPendingJob() {
+	if (currentThread >= queues.size()) return false;
+
+	// Prefer our own most recently spawned job, it's likely still in cache
+	if (std::optional<Job*> job = queues[currentThread]->pop()) {
+		runJob(**job);
+		return true;
+	}
+
+	// Steal the oldest job of another thread, usually the largest remaining range
+	for (size_t i = 1; i < queues.size(); i++) {
+		if (std::optional<Job*> job = queues[(currentThread + i) % queues.size()]->steal()) {
+			runJob(**job);
+			return true;
+		}
+	}
+
+	return false;
+}
+
+/**
+ * Recursively splits a range in half, spawning the upper halves as jobs until the range is within the grain size, then
+ * waits for the spawned halves
+ * @param begin The first index of the range
+ * @param end The index past the last of the range
+ * @param grain The maximum number of indices to run as a single job
+ * @param func The function to run on each sub range
+ */
+void JobSystem::splitRange(size_t begin, size_t end, size_t grain, const std::function<void(size_t, size_t)>& func) {
+	// Groups may only be spawned in by their own thread, so each split owns a group for the halves it spawns
+	TaskGroup group(*this);
+	while (end - begin > grain) {
+		size_t middle = begin + (end - begin) / 2;
+		group.run([this, &func, middle, end, grain]() { splitRange(middle, end, grain, func); });
+		end = middle;
+	}
+	func(begin, end);
+	group.wait();
+}
+
+/**
+ * Calls func on sub ranges of [begin, end) in parallel across the update threads and waits for every call to complete.
+ * Must only be called from pre update or update (or from within another job).
+ * @param begin The first index of the range
+ * @param end The index past the last of the range
+ * @param grain The maximum number of indices passed to a single call of func
+ * @param func The function to call with the first index and the index past the last of each sub range
+ */
+void JobSystem::parallelFor(size_t begin, size_t end, size_t grain, const std::function<void(size_t, size_t)>& func) {
+	if (begin >= end) return;
+	splitRange(begin, end, std::max<size_t>(grain, 1), func);
+}
+
+/**
+ * Creates a new task group
+ * @param jobSystem The job system to spawn jobs in
+ */
+TaskGroup::TaskGroup(JobSystem& jobSystem) : jobSystem(jobSystem), pending(0) {
+	// Empty Body
+}
+
+/**
+ * Waits for any jobs still running
+ */
+TaskGroup::~TaskGroup() {
+	// Other threads may still hold pointers to our jobs, so they must finish even if the exception is never seen
+	while (pending.load(std::memory_order_acquire) != 0)
+		if (!jobSystem.runPendingJob()) std::this_thread::yield();
+}
+
+/**
+ * Spawns a job within the group
+ * @param task The work to run
+ */
+void TaskGroup::run(Task task) {
+	pending.fetch_add(1, std::memory_order_relaxed);
+	jobs.push_back(Job{std::move(task), this});
+	jobSystem.push(jobs.back());
+}
+
+/**
+ * Waits for every job in the group to complete, running pending jobs while waiting
+ * @throws The first exception thrown by a job in the group
+ */
+void TaskGroup::wait() {
+	while (pending.load(std::memory_order_acquire) != 0)
+		if (!jobSystem.runPendingJob()) std::this_thread::yield();
+
+	jobs.clear();
+	if (exception == nullptr) return;
+	std::exception_ptr thrown = exception;
+	exception = nullptr;
+	std::rethrow_exception(thrown);
+}
@@ -0,0 +1,198 @@
+/*
+   Copyright 2022 Rishi Challa
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+	   http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+#pragma once
+
+#include <Kale/Core/Task/Task.hpp>
+#include <Kale/Core/WorkStealingDeque/WorkStealingDeque.hpp>
+
+#include <atomic>
+#include <deque>
+#include <vector>
+#include <memory>
+#include <functional>
+#include <exception>
+#include <mutex>
+#include <limits>
+#include <cstddef>
+
+namespace Kale {
+
+	/**
+	 * Forward declaration of the task group class
+	 */
+	class TaskGroup;
+
+	/**
+	 * A single unit of work spawned within a task group
+	 */
+	struct Job {
+
+		/**
+		 * The work to run
+		 */
+		Task task;
+
+		/**
+		 * The group the job belongs to
+		 */
+		TaskGroup* group;
+	};
+
+	/**
+	 * A fork/join job system sharing the scene's update threads. Nodes may spawn jobs during pre updating or updating
+	 * and must join them before returning. Threads waiting on jobs, or waiting for other threads to finish their nodes,
+	 * run pending jobs rather than sleeping.
+	 */
+	class JobSystem {
+	private:
+
+		/**
+		 * The per thread deques of jobs, the owning thread pushes and pops while other threads steal
+		 */
+		std::vector<std::unique_ptr<WorkStealingDeque<Job*>>> queues;
+
+		/**
+		 * The index of the update thread the calling thread is, or max if it isn't an update thread
+		 */
+		static inline thread_local size_t currentThread = std::numeric_limits<size_t>::max();
+
+		/**
+		 * Runs a job & marks it as complete within its group
+		 * @param job The job to run
+		 */
+		static void runJob(Job& job);
+
+		/**
+		 * Recursively splits a range in half, spawning the upper halves as jobs until the range is within the grain size, then
+		 * waits for the spawned halves
+		 * @param begin The first index of the range
+		 * @param end The index past the last of the range
+		 * @param grain The maximum number of indices to run as a single job
+		 * @param func The function to run on each sub range
+		 */
+		void splitRange(size_t begin, size_t end, size_t grain, const std::function<void(size_t, size_t)>& func);
+
+		friend class TaskGroup;
+
+	public:
+
+		/**
+		 * Creates a new job system
+		 * @param numThreads The number of update threads sharing the job system
+		 * @param capacity The number of jobs each thread can hold pending, jobs spawned beyond this are run immediately
+		 */
+		JobSystem(size_t numThreads, size_t capacity = 1024);
+
+		/**
+		 * Sets the update thread index of the calling thread, called by the scene at the start of each update
+		 * @param threadNum The index of the update thread
+		 */
+		static void setCurrentThread(size_t threadNum);
+
+		/**
+		 * Pushes a job to the calling thread's deque, running it immediately if the calling thread is not an update thread or the
+		 * deque is full
+		 * @param job The job to push
+		 */
+		void push(Job& job);
+
+		/**
+		 * Runs a single pending job, taken from the calling thread's deque if possible and stolen from another thread otherwise
+		 * @returns False if no job was found
+		 */
+		bool runPendingJob();
+
+		/**
+		 * Calls func on sub ranges of [begin, end) in parallel across the update threads and waits for every call to complete.
+		 * Must only be called from pre update or update (or from within another job).
+		 * @param begin The first index of the range
+		 * @param end The index past the last of the range
+		 * @param grain The maximum number of indices passed to a single call of func
+		 * @param func The function to call with the first index and the index past the last of each sub range
+		 */
+		void parallelFor(size_t begin, size_t end, size_t grain, const std::function<void(size_t, size_t)>& func);
+	};
+
+	/**
+	 * A group of jobs which can be waited on together. Jobs may be spawned and waited on only by the thread which created the group.
+	 */
+	class TaskGroup {
+	private:
+
+		/**
+		 * The job system the jobs are spawned in
+		 */
+		JobSystem& jobSystem;
+
+		/**
+		 * The storage for the group's jobs, a deque so pushing doesn't move jobs other threads hold
+		 */
+		std::deque<Job> jobs;
+
+		/**
+		 * The number of jobs spawned which have not yet completed
+		 */
+		std::atomic<size_t> pending;
+
+		/**
+		 * The first exception thrown by a job in the group, rethrown from wait
+		 */
+		std::exception_ptr exception;
+
+		/**
+		 * Used for synchronizing access to the exception
+		 */
+		std::mutex exceptionMutex;
+
+		friend class JobSystem;
+
+	public:
+
+		/**
+		 * Creates a new task group
+		 * @param jobSystem The job system to spawn jobs in
+		 */
+		explicit TaskGroup(JobSystem& jobSystem);
+
+		/**
+		 * Task groups do not support copying
+		 */
+		TaskGroup(const TaskGroup& other) = delete;
+
+		/**
+		 * Task groups do not support copying
+		 */
+		void operator=(const TaskGroup& other) = delete;
+
+		/**
+		 * Waits for any jobs still running
+		 */
+		~TaskGroup();
+
+		/**
+		 * Spawns a job within the group
+		 * @param task The work to run
+		 */
+		void run(Task task);
+
+		/**
+		 * Waits for every job in the group to complete, running pending jobs while waiting
+		 * @throws The first exception thrown by a job in the group
+		 */
+		void wait();
+	};
+}
@@ -0,0 +1,146 @@
+/*
+   Copyright 2022 Rishi Challa
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+	   http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+#pragma once
+
+#include <atomic>
+#include <memory>
+#include <optional>
+#include <new>
+#include <utility>
+#include <cstdint>
+#include <cstddef>
+
+namespace Kale {
+
+	/**
+	 * A bounded lock free multi producer single consumer ring queue. Any thread may push, only one thread at a time may pop.
+	 * Each cell carries a sequence number so producers only contend on a single atomic index.
+	 * @tparam T The type of item held
+	 */
+	template <typename T> class MPSCQueue {
+	private:
+
+		/**
+		 * A single cell of the ring buffer
+		 */
+		struct Cell {
+
+			/**
+			 * The position the cell is ready to be pushed to, or the position plus one once it holds an item ready to be popped
+			 */
+			std::atomic<size_t> sequence;
+
+			/**
+			 * The storage for the item held by the cell
+			 */
+			alignas(T) unsigned char storage[sizeof(T)];
+		};
+
+		/**
+		 * The ring buffer of cells
+		 */
+		std::unique_ptr<Cell[]> buffer;
+
+		/**
+		 * The capacity of the ring buffer, always a power of two
+		 */
+		size_t capacity;
+
+		/**
+		 * The position the next item is pushed to, shared between producers
+		 */
+		alignas(64) std::atomic<size_t> pushPosition;
+
+		/**
+		 * The position the next item is popped from, only accessed by the consumer
+		 */
+		alignas(64) size_t popPosition;
+
+	public:
+
+		/**
+		 * Creates a new queue
+		 * @param minCapacity The minimum capacity of the queue, rounded up to a power of two
+		 */
+		explicit MPSCQueue(size_t minCapacity = 1024) : capacity(1), pushPosition(0), popPosition(0) {
+			while (capacity < minCapacity) capacity <<= 1;
+			buffer = std::make_unique<Cell[]>(capacity);
+			for (size_t i = 0; i < capacity; i++) buffer[i].sequence.store(i, std::memory_order_relaxed);
+		}
+
+		/**
+		 * MPSC queues do not support copying
+		 */
+		MPSCQueue(const MPSCQueue& other) = delete;
+
+		/**
+		 * MPSC queues do not support copying
+		 */
+		void operator=(const MPSCQueue& other) = delete;
+
+		/**
+		 * Destroys any items left within the queue
+		 */
+		~MPSCQueue() {
+			while (pop().has_value());
+		}
+
+		/**
+		 * Pushes an item to the queue, may be called from any thread
+		 * @param item The item to push
+		 * @returns False if the queue is full and the item was not pushed, in which case item is left untouched
+		 */
+		bool push(T&& item) {
+			size_t position = pushPosition.load(std::memory_order_relaxed);
+			Cell* cell;
+			while (true) {
+				cell = &buffer[position & (capacity - 1)];
+				size_t sequence = cell->sequence.load(std::memory_order_acquire);
+				intptr_t difference = static_cast<intptr_t>(sequence) - static_cast<intptr_t>(position);
+
+				// The cell is free, try to claim it
+				if (difference == 0) {
+					if (pushPosition.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)) break;
+				}
+				// The cell still holds an item from the previous lap, the queue is full
+				else if (difference < 0) return false;
+				// Another producer claimed the cell first
+				else position = pushPosition.load(std::memory_order_relaxed);
+			}
+
+			new (cell->storage) T(std::move(item));
+			cell->sequence.store(position + 1, std::memory_order_release);
+			return true;
+		}
+
+		/**
+		 * Pops an item from the queue, may only be called from the consumer thread
+		 * @returns The item, or nullopt if the queue is empty or the next item is still being pushed
+		 */
+		std::optional<T> pop() {
+			Cell& cell = buffer[popPosition & (capacity - 1)];
+			if (cell.sequence.load(std::memory_order_acquire) != popPosition + 1) return std::nullopt;
+
+			T* stored = std::launder(reinterpret_cast<T*>(cell.storage));
+			std::optional<T> item(std::move(*stored));
+			stored->~T();
+			cell.sequence.store(popPosition + capacity, std::memory_order_release);
+			popPosition++;
+			return item;
+		}
+	};
+}
@@ -0,0 +1,123 @@
+/*
+   Copyright 2022 Rishi Challa
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+	   http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+
+#include "MappedFile.hpp"
+
+#include <stdexcept>
+
+#ifdef KALE_WINDOWS
+#include <Windows.h>
+#else
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+using namespace Kale;
+
+#ifdef KALE_WINDOWS
+
+/**
+ * Maps a file into memory
+ * @param path The path of the file
+ * @throws If the file could not be opened or mapped
+ */
+MappedFile::MappedFile(const std::string& path) : mapping(nullptr), fileSize(0), fileHandle(nullptr), mappingHandle(nullptr) {
+	HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+	if (file == INVALID_HANDLE_VALUE) throw std::runtime_error("Unable to open " + path);
+	fileHandle = file;
+
+	LARGE_INTEGER size;
+	if (!GetFileSizeEx(file, &size)) {
+		CloseHandle(file);
+		throw std::runtime_error("Unable to get the size of " + path);
+	}
+	fileSize = static_cast<size_t>(size.QuadPart);
+	if (fileSize == 0) return;
+
+	mappingHandle = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+	if (mappingHandle != nullptr) mapping = static_cast<const uint8_t*>(MapViewOfFile(mappingHandle, FILE_MAP_READ, 0, 0, 0));
+	if (mapping == nullptr) {
+		if (mappingHandle != nullptr) CloseHandle(mappingHandle);
+		CloseHandle(file);
+		throw std::runtime_error("Unable to map " + path);
+	}
+}
+
+/**
+ * Unmaps the file
+ */
+MappedFile::~MappedFile() {
+	if (mapping != nullptr) UnmapViewOfFile(mapping);
+	if (mappingHandle != nullptr) CloseHandle(mappingHandle);
+	if (fileHandle != nullptr) CloseHandle(fileHandle);
+}
+
+#else
+
+/**
+ * Maps a file into memory
+ * @param path The path of the file
+ * @throws If the file could not be opened or mapped
+ */
+MappedFile::MappedFile(const std::string& path) : mapping(nullptr), fileSize(0) {
+	int file = open(path.c_str(), O_RDONLY);
+	if (file == -1) throw std::runtime_error("Unable to open " + path);
+
+	struct stat status;
+	if (fstat(file, &status) == -1) {
+		close(file);
+		throw std::runtime_error("Unable to get the size of " + path);
+	}
+	fileSize = static_cast<size_t>(status.st_size);
+	if (fileSize == 0) {
+		close(file);
+		return;
+	}
+
+	// The mapping holds its own reference to the file, so the descriptor can be closed straight away
+	void* contents = mmap(nullptr, fileSize, PROT_READ, MAP_PRIVATE, file, 0);
+	close(file);
+	if (contents == MAP_FAILED) throw std::runtime_error("Unable to map " + path);
+	mapping = static_cast<const uint8_t*>(contents);
+}
+
+/**
+ * Unmaps the file
+ */
+MappedFile::~MappedFile() {
+	if (mapping != nullptr) munmap(const_cast<uint8_t*>(mapping), fileSize);
+}
+
+#endif
+
+/**
+ * Gets the mapped contents of the file
+ * @returns The contents, nullptr if the file is empty
+ */
+const uint8_t* MappedFile::data() const {
+	return mapping;
+}
+
+/**
+ * Gets the size of the file
+ * @returns The size in bytes
+ */
+size_t MappedFile::size() const {
+	return fileSize;
+}
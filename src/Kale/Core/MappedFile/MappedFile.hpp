@@ -0,0 +1,93 @@
+/*
+   Copyright 2022 Rishi Challa
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+	   http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+
+#pragma once
+
+#include <string>
+#include <cstdint>
+#include <cstddef>
+
+namespace Kale {
+
+	/**
+	 * A read only memory mapping of a file, the file's contents are paged in by the operating system as they are accessed rather
+	 * than copied up front
+	 */
+	class MappedFile {
+	private:
+
+		/**
+		 * The start of the mapped contents, nullptr if the file is empty
+		 */
+		const uint8_t* mapping;
+
+		/**
+		 * The size of the file in bytes
+		 */
+		size_t fileSize;
+
+#ifdef KALE_WINDOWS
+
+		/**
+		 * The handle of the open file
+		 */
+		void* fileHandle;
+
+		/**
+		 * The handle of the file mapping object
+		 */
+		void* mappingHandle;
+
+#endif
+
+	public:
+
+		/**
+		 * Maps a file into memory
+		 * @param path The path of the file
+		 * @throws If the file could not be opened or mapped
+		 */
+		explicit MappedFile(const std::string& path);
+
+		/**
+		 * Mapped files do not support copying
+		 */
+		MappedFile(const MappedFile& other) = delete;
+
+		/**
+		 * Mapped files do not support copying
+		 */
+		void operator=(const MappedFile& other) = delete;
+
+		/**
+		 * Unmaps the file
+		 */
+		~MappedFile();
+
+		/**
+		 * Gets the mapped contents of the file
+		 * @returns The contents, nullptr if the file is empty
+		 */
+		const uint8_t* data() const;
+
+		/**
+		 * Gets the size of the file
+		 * @returns The size in bytes
+		 */
+		size_t size() const;
+	};
+}
@@ -31,19 +31,46 @@
 #endif
 
 #include <algorithm>
+#include <numeric>
+#include <iterator>
+#include <chrono>
+#include <cmath>
+#include <thread>
 #include <sstream>
 
 using namespace Kale;
 
+/**
+ * Creates the scheduling state of a phase
+ * @param func The node function called on every node during this phase
+ * @param averageTime The node's measured average time member for this phase
+ * @param location The node's location member for this phase's lists
+ * @param pendingDependencies The node's counter of dependencies yet to finish this phase
+ * @param numThreads The number of update threads
+ */
+Scene::UpdatePhase::UpdatePhase(void (Node::*func)(size_t, const Scene&, float), float Node::*averageTime,
+	std::pair<size_t, size_t> Node::*location, std::atomic<uint32_t> Node::*pendingDependencies, size_t numThreads) :
+	nodes(numThreads), remaining(0), func(func), averageTime(averageTime), location(location), pendingDependencies(pendingDependencies) {
+	for (size_t i = 0; i < numThreads; i++) {
+		queues.push_back(std::make_unique<WorkStealingDeque<uint32_t>>());
+		readyQueues.push_back(std::make_unique<WorkStealingDeque<Node*>>());
+	}
+}
+
 /**
  * Constructs a new scene
  */
-Scene::Scene() {
-	updateNodes.resize(std::thread::hardware_concurrency());
-	preUpdateNodes.resize(std::thread::hardware_concurrency());
-	threadedNodePerformanceTimes.resize(std::thread::hardware_concurrency());
-	nodesPreUpdated = std::thread::hardware_concurrency();
-	generation = 0;
+Scene::Scene() :
+	preUpdatePhase(&Node::preUpdate, &Node::averagePreUpdateTime, &Node::preUpdateLocation, &Node::pendingPreUpdateDependencies,
+		mainApp->getNumUpdateThreads()),
+	updatePhase(&Node::update, &Node::averageUpdateTime, &Node::updateLocation, &Node::pendingUpdateDependencies,
+		mainApp->getNumUpdateThreads()),
+	jobSystem(mainApp->getNumUpdateThreads()), preUpdateBarrier(mainApp->getNumUpdateThreads()) {
+	threadedNodePerformanceTimes.resize(mainApp->getNumUpdateThreads());
+	idleNodes.resize(mainApp->getNumUpdateThreads());
+	sceneTime = 0.0;
+	chunksOutdated = true;
+	framesSinceBalanceCheck = 0;
 
 	Vector2f size = mainApp->getWindow().getFramebufferSize().cast<float>();
 	viewport = {size.x * 1080.0f / size.y, 1080.0f};
@@ -57,14 +84,19 @@ Scene::Scene() {
  * Constructs a new scene from a scene save file
  * @param filename The filename of the scene JSON file
  */
-Scene::Scene(const std::string& filename) {
+Scene::Scene(const std::string& filename) :
+	preUpdatePhase(&Node::preUpdate, &Node::averagePreUpdateTime, &Node::preUpdateLocation, &Node::pendingPreUpdateDependencies,
+		mainApp->getNumUpdateThreads()),
+	updatePhase(&Node::update, &Node::averageUpdateTime, &Node::updateLocation, &Node::pendingUpdateDependencies,
+		mainApp->getNumUpdateThreads()),
+	jobSystem(mainApp->getNumUpdateThreads()), preUpdateBarrier(mainApp->getNumUpdateThreads()) {
 
 	// Default Setup
-	updateNodes.resize(std::thread::hardware_concurrency());
-	preUpdateNodes.resize(std::thread::hardware_concurrency());
-	threadedNodePerformanceTimes.resize(std::thread::hardware_concurrency());
-	nodesPreUpdated = std::thread::hardware_concurrency();
-	generation = 0;
+	threadedNodePerformanceTimes.resize(mainApp->getNumUpdateThreads());
+	idleNodes.resize(mainApp->getNumUpdateThreads());
+	sceneTime = 0.0;
+	chunksOutdated = true;
+	framesSinceBalanceCheck = 0;
 
 	Vector2f size = mainApp->getWindow().getFramebufferSize().cast<float>();
 	viewport = {size.x * 1080.0f / size.y, 1080.0f};
@@ -73,30 +105,24 @@ Scene::Scene(const std::string& filename) {
 	worldToScreen.translate(Vector2f(1920.0f, 1080.0f) / -2.0f);
 	sceneBounds = Rect{{(1920.0f - viewport.x) / 2.0f, 1080.0f}, {(1920.0f + viewport.x) / 2.0f, 0.0f}};
 
-	// Run the loading on the main thread, this way it is done after the node map is populated and is done without concern for where
-	// the constructor is called from
-	mainApp->runTaskOnMainThread([&, filename]() {
-		try {
-			// Load json from file
-			std::ifstream jsonFile(mainApp->getAssetFolderPath() + filename);
-			JSON sceneConfig = JSON::parse(jsonFile, nullptr, true, true);
-			bgColor = sceneConfig["bgColor"].get<Color>();
-			camera = sceneConfig["camera"].get<Camera>();
-
-			// Get the nodes in JSON form then loop through them and parse them/add them
-			std::vector<JSON> nodes = sceneConfig["nodes"].get<std::vector<JSON>>();
-			for (const JSON& json : nodes) {
-				std::shared_ptr<Node> node = nodeMap[json["node"].get<std::string>()](json);
-				addNode(node);
-			}
-		}
-		catch (const std::exception& e) {
-			using namespace std::string_literals;
-			console.warn("Scene Loading Failed - "s + e.what());
-		}
+	// Start loading on the main thread, this way it is done after the node map is populated and is done without concern for where
+	// the constructor is called from. The file is then parsed and the nodes constructed in the background.
+	loader = std::make_shared<SceneLoader>(mainApp->getAssetFolderPath() + filename);
+	mainApp->addLoadingScene(this);
+	mainApp->runTaskOnMainThread([loader = loader]() {
+		loader->start();
 	});
 }
 
+/**
+ * Stops loading the scene file if still loading
+ */
+Scene::~Scene() {
+	if (loader == nullptr) return;
+	mainApp->removeLoadingScene(this);
+	loader->cancel();
+}
+
 /**
  * Called when the event is fired
  */
@@ -112,103 +138,285 @@ void Scene::onWindowResize(Vector2ui oldSize, Vector2ui newSize) {
 
 /**
  * Updates the data structures holding nodes based off of the queues, MUST be called on the main thread
- * after the completion of all updates in the frame.
+ * after the completion of all updates in the frame. Nodes are added until the deadline passes, the rest are carried over.
+ * @param deadline The time to stop beginning added nodes at, at least one node is always added
  */
-void Scene::updateNodeStructures() {
+void Scene::updateNodeStructures(std::chrono::steady_clock::time_point deadline) {
 
-	// Return if no nodes need to be added
-	if (nodesToAdd.empty() && nodesToRemove.empty()) return;
-
-	// Add all the nodes till there's none left to add
-	while (!nodesToAdd.empty()) {
-		// Get the node and add it to the main list
-		std::shared_ptr<Node> node = nodesToAdd.front();
-		nodesToAdd.pop();
-		nodes.push_back(node);
-
-		// Find the thread with the current smallest total update time
-		size_t threadIndex = std::distance(threadedNodePerformanceTimes.begin(),
-			std::min_element(threadedNodePerformanceTimes.begin(), threadedNodePerformanceTimes.end(),
-				[](const std::pair<float, float>& a, const std::pair<float, float>& b) -> bool {
-					return a.first > b.first;
-				}
-			)
-		);
-
-		// Add the node to the thread with the smallest update time and add it to the thread's total time
-		threadedNodePerformanceTimes[threadIndex].first += node->updateTime;
-		updateNodes[threadIndex].push_back(node);
-
-		// Find the thread with the current smallest total pre update time
-		threadIndex = std::distance(threadedNodePerformanceTimes.begin(),
-			std::min_element(threadedNodePerformanceTimes.begin(), threadedNodePerformanceTimes.end(),
-				[](const std::pair<float, float>& a, const std::pair<float, float>& b) -> bool {
-					return a.second > b.second;
-				}
-			)
-		);
+	// Sleeping & waking happens first, while the dependency graph still only refers to held nodes
+	updateActiveNodes();
+	lastStructureChange = FrameRecorder::StructureChange();
 
-		// Add the node to the thread with the smallest pre update time and add it to the thread's total time
-		threadedNodePerformanceTimes[threadIndex].second += node->preUpdateTime;
-		preUpdateNodes[threadIndex].push_back(node);
+	// Take the queued nodes as a batch, behind any nodes carried over from earlier frames
+	std::vector<std::shared_ptr<Node>> adding = takeQueuedNodes(nodesToAdd, overflowNodesToAdd, nodesToAddOverflowed);
+	std::vector<std::shared_ptr<Node>> removing = takeQueuedNodes(nodesToRemove, overflowNodesToRemove, nodesToRemoveOverflowed);
+	carriedNodesToAdd.insert(carriedNodesToAdd.end(), std::make_move_iterator(adding.begin()), std::make_move_iterator(adding.end()));
+	if (loader != nullptr) loader->takeNodes(loadedNodesToAdd, bgColor, camera);
 
-		node->begin(*this);
+	// Return if no nodes need to be added
+	if (carriedNodesToAdd.empty() && loadedNodesToAdd.empty() && removing.empty()) return;
+	chunksOutdated = true;
+
+	// Checks whether or not a node is held in this scene
+	const auto isHeld = [&](const std::shared_ptr<Node>& node) -> bool {
+		const std::shared_ptr<Node>* held = nodes.get(node->sceneHandle);
+		return held != nullptr && *held == node;
+	};
+
+	// Nodes removed before they were added are never added, loaded nodes dropped this way still count as begun so loading finishes
+	size_t numLoadedDropped = 0;
+	for (const std::shared_ptr<Node>& node : removing) {
+		if (isHeld(node)) continue;
+		auto carried = std::find(carriedNodesToAdd.begin(), carriedNodesToAdd.end(), node);
+		if (carried != carriedNodesToAdd.end()) carriedNodesToAdd.erase(carried);
+		auto loaded = std::find(loadedNodesToAdd.begin(), loadedNodesToAdd.end(), node);
+		if (loaded == loadedNodesToAdd.end()) continue;
+		loadedNodesToAdd.erase(loaded);
+		numLoadedDropped++;
 	}
 
-	while (!nodesToRemove.empty()) {
-		// Get the node and remove it from the main list
-		std::shared_ptr<Node> node = nodesToRemove.front();
-		nodesToRemove.pop();
-		nodes.remove(node);
+	// Add the nodes until the deadline passes, every node starts awake. Nodes from the scene file are added behind any others.
+	bool outOfTime = false;
+	const auto beginQueued = [&](std::deque<std::shared_ptr<Node>>& queue) -> size_t {
+		size_t added = 0;
+		while (!outOfTime && !queue.empty()) {
+			std::shared_ptr<Node> node = std::move(queue.front());
+			queue.pop_front();
+			added++;
+			if (isHeld(node)) continue;
+
+			node->sceneHandle = nodes.insert(node);
+			node->owningScene = this;
+			node->sleeping = false;
+			node->lastUpdateTime = sceneTime;
+			activateNode(node.get());
+			node->begin(*this);
+			if (renderSnapshotTaken) node->takeRenderSnapshot();
+			lastStructureChange.addNode(node->name);
+			outOfTime = std::chrono::steady_clock::now() >= deadline;
+		}
+		return added;
+	};
+	nodes.reserve(nodes.size() + carriedNodesToAdd.size() + loadedNodesToAdd.size());
+	beginQueued(carriedNodesToAdd);
+	size_t numLoadedAdded = beginQueued(loadedNodesToAdd);
+	if (loader != nullptr) loader->nodesBegun(numLoadedAdded + numLoadedDropped);
+
+	// Remove all the nodes, each removal is constant time as every node knows where it is held
+	for (const std::shared_ptr<Node>& node : removing) {
+		if (!isHeld(node)) continue;
+		if (!node->sleeping) deactivateNode(node.get());
+
+		nodes.erase(node->sceneHandle);
+		node->sceneHandle = SlotHandle();
+		node->owningScene = nullptr;
+		node->end(*this);
+		lastStructureChange.removeNode(node->name);
+	}
 
-		bool updateFound = false;
-		bool preUpdateFound = false;
+	// Rebuild the dependency graph now, so it never refers to removed nodes
+	buildDependencyGraph();
+}
 
-		// Loop through the threads till we find the thread holding the update
-		for (size_t threadIndex = 0; threadIndex < updateNodes.size(); threadIndex++) {
+/**
+ * Queues a sleeping node to be woken, falling back to the overflow list if the queue is full. Can be called on the main thread or
+ * any update thread.
+ * @param handle The handle of the node to wake
+ */
+void Scene::queueWake(SlotHandle handle) {
+	if (nodesToWake.push(std::move(handle))) return;
+	std::lock_guard guard(nodeQueueUpdateMutex);
+	overflowNodesToWake.push_back(handle);
+}
 
-			if (updateFound && preUpdateFound) break;
+/**
+ * Wakes the queued nodes & puts the idle nodes to sleep, MUST be called on the main thread after the completion of all updates
+ * in the frame.
+ */
+void Scene::updateActiveNodes() {
 
-			if (!updateFound) {
-				// Check if the node is updated in this thread
-				auto it = std::find(updateNodes[threadIndex].begin(), updateNodes[threadIndex].end(), node);
-				if (it != updateNodes[threadIndex].end()) {
-					// Remove the node from updates & update the performance times
-					threadedNodePerformanceTimes[threadIndex].first -= node->updateTime;
-					updateNodes[threadIndex].erase(it);
-					updateFound = true;
-				}
-			}
+	// Wake the queued nodes, the handles of removed nodes no longer resolve
+	const auto wakeHandle = [&](SlotHandle handle) {
+		if (std::shared_ptr<Node>* node = nodes.get(handle)) wakeNode(node->get());
+	};
+	while (std::optional<SlotHandle> handle = nodesToWake.pop()) wakeHandle(*handle);
+	{
+		std::lock_guard guard(nodeQueueUpdateMutex);
+		for (SlotHandle handle : overflowNodesToWake) wakeHandle(handle);
+		overflowNodesToWake.clear();
+	}
 
-			if (!preUpdateFound) {
-				// Check if the node is pre updated in this thread
-				auto it = std::find(preUpdateNodes[threadIndex].begin(), preUpdateNodes[threadIndex].end(), node);
-				if (it != preUpdateNodes[threadIndex].end()) {
-					// Remove the node from updates & update the performance times
-					threadedNodePerformanceTimes[threadIndex].second -= node->preUpdateTime;
-					preUpdateNodes[threadIndex].erase(it);
-					preUpdateFound = true;
-				}
-			}
+	// Put the idle nodes to sleep unless they were woken during or since their update, deferred nodes are woken by their timer
+	for (std::vector<Node*>& threadNodes : idleNodes) {
+		for (Node* node : threadNodes) {
+			if (node->wakeRequested.exchange(false, std::memory_order_relaxed)) continue;
+			sleepNode(node);
+			if (node->sleepDelay <= 0.0f) continue;
+			uint64_t due = static_cast<uint64_t>(std::ceil((node->lastUpdateTime + node->sleepDelay) / timerResolution));
+			nodeTimers.schedule(due, std::make_pair(node->sceneHandle, node->timerGeneration));
+			if (node->lodDeferred) lodDeferredNodes.push_back(std::make_pair(node->sceneHandle, node->timerGeneration));
 		}
+		threadNodes.clear();
+	}
+}
 
-		node->end(*this);
+/**
+ * Wakes a node and every node depending on it, adding the sleeping nodes back into both phases
+ * @param node The node to wake
+ */
+void Scene::wakeNode(Node* node) {
+
+	// Awake nodes are flagged so they aren't put to sleep if they were found idle this frame. Nodes which slept until woken are
+	// passed a single frame's time, as nothing was simulated while they slept.
+	if (!node->sleeping) node->wakeRequested.store(true, std::memory_order_relaxed);
+	else {
+		node->wakeRequested.store(false, std::memory_order_relaxed);
+		node->sleeping = false;
+		node->timerGeneration++;
+		if (node->sleepDelay <= 0.0f) node->lastUpdateTime = sceneTime;
+		activateNode(node);
+		for (Node* dependent : node->dependents) dependent->numAwakeDependencies++;
+		chunksOutdated = true;
 	}
+
+	for (Node* dependent : node->dependents) wakeNode(dependent);
+}
+
+/**
+ * Puts a node to sleep, removing it from both phases & invalidating its previous timer
+ * @param node The node to put to sleep
+ */
+void Scene::sleepNode(Node* node) {
+	if (node->sleeping) return;
+	node->sleeping = true;
+	node->timerGeneration++;
+	deactivateNode(node);
+	for (Node* dependent : node->dependents) dependent->numAwakeDependencies--;
+	chunksOutdated = true;
 }
 
 /**
- * Renders the current scene
+ * Assigns a node to the threads with the smallest total pre update and update times
+ * @param node The node to assign
+ */
+void Scene::activateNode(Node* node) {
+
+	// Find the thread with the current smallest total update time
+	size_t threadIndex = std::distance(threadedNodePerformanceTimes.begin(),
+		std::min_element(threadedNodePerformanceTimes.begin(), threadedNodePerformanceTimes.end(),
+			[](const std::pair<float, float>& a, const std::pair<float, float>& b) -> bool {
+				return a.first < b.first;
+			}
+		)
+	);
+
+	// Add the node to the thread with the smallest update time and add it to the thread's total time
+	threadedNodePerformanceTimes[threadIndex].first += node->averageUpdateTime;
+	assignNode(updatePhase, node, threadIndex);
+
+	// Find the thread with the current smallest total pre update time
+	threadIndex = std::distance(threadedNodePerformanceTimes.begin(),
+		std::min_element(threadedNodePerformanceTimes.begin(), threadedNodePerformanceTimes.end(),
+			[](const std::pair<float, float>& a, const std::pair<float, float>& b) -> bool {
+				return a.second < b.second;
+			}
+		)
+	);
+
+	// Add the node to the thread with the smallest pre update time and add it to the thread's total time
+	threadedNodePerformanceTimes[threadIndex].second += node->averagePreUpdateTime;
+	assignNode(preUpdatePhase, node, threadIndex);
+}
+
+/**
+ * Removes a node from both phases and from the total times of its threads
+ * @param node The node to remove
+ */
+void Scene::deactivateNode(Node* node) {
+	threadedNodePerformanceTimes[node->updateLocation.first].first -= node->averageUpdateTime;
+	threadedNodePerformanceTimes[node->preUpdateLocation.first].second -= node->averagePreUpdateTime;
+	unassignNode(updatePhase, node);
+	unassignNode(preUpdatePhase, node);
+}
+
+/**
+ * Queues a node to be added or removed, falling back to the overflow list if the queue is full. Can be called on any thread.
+ * Nodes queued by one thread, or otherwise queued one after another, are taken in the order queued. Nodes queued concurrently
+ * by different threads have no defined order.
+ * @param queue The queue to push the node to
+ * @param overflow The list to push the node to if the queue is full
+ * @param overflowed Whether or not the overflow list holds nodes
+ * @param node The node to queue
+ */
+void Scene::queueNode(MPSCQueue<std::shared_ptr<Node>>& queue, std::vector<std::shared_ptr<Node>>& overflow, std::atomic<bool>& overflowed,
+	std::shared_ptr<Node> node) {
+	if (!overflowed.load(std::memory_order_acquire) && queue.push(std::move(node))) return;
+
+	// Once a node has overflowed, later nodes are queued behind it until the overflow is taken
+	std::lock_guard guard(nodeQueueUpdateMutex);
+	overflow.push_back(std::move(node));
+	overflowed.store(true, std::memory_order_release);
+}
+
+/**
+ * Takes all the nodes queued in a queue and its overflow list, MUST be called on the main thread
+ * @param queue The queue to take nodes from
+ * @param overflow The overflow list to take nodes from
+ * @param overflowed Whether or not the overflow list holds nodes
+ * @returns The queued nodes
+ */
+std::vector<std::shared_ptr<Node>> Scene::takeQueuedNodes(MPSCQueue<std::shared_ptr<Node>>& queue,
+	std::vector<std::shared_ptr<Node>>& overflow, std::atomic<bool>& overflowed) {
+
+	std::vector<std::shared_ptr<Node>> queued;
+	while (std::optional<std::shared_ptr<Node>> node = queue.pop()) queued.push_back(std::move(*node));
+
+	std::lock_guard guard(nodeQueueUpdateMutex);
+	queued.insert(queued.end(), std::make_move_iterator(overflow.begin()), std::make_move_iterator(overflow.end()));
+	overflow.clear();
+	overflowed.store(false, std::memory_order_release);
+	return queued;
+}
+
+/**
+ * Appends a node to a thread's list and stores its location within the node
+ * @param phase The phase whose lists to append the node to
+ * @param node The node to append
+ * @param thread The thread to append the node to
+ */
+void Scene::assignNode(UpdatePhase& phase, Node* node, size_t thread) {
+	node->*phase.location = std::make_pair(thread, phase.nodes[thread].size());
+	phase.nodes[thread].push_back(node);
+}
+
+/**
+ * Removes a node from its thread's list in constant time by moving the last node of the list into its place
+ * @param phase The phase whose lists to remove the node from
+ * @param node The node to remove
+ */
+void Scene::unassignNode(UpdatePhase& phase, Node* node) {
+	std::vector<Node*>& threadNodes = phase.nodes[(node->*phase.location).first];
+	Node* last = threadNodes.back();
+	threadNodes[(node->*phase.location).second] = last;
+	last->*phase.location = node->*phase.location;
+	threadNodes.pop_back();
+}
+
+/**
+ * Renders the current scene from the last render snapshot
  * @param deltaTime The time the last frame has taken to update and render
  */
 void Scene::render(float deltaTime) const {
 
 #ifdef KALE_OPENGL
-	OpenGL::Core::clearScreen(bgColor);
+	OpenGL::Core::clearScreen(renderBgColor);
 #endif
 
-	Transform cameraToScreen(worldToScreen * camera);
+	Transform cameraToScreen(worldToScreen * renderCamera);
 	for (const std::shared_ptr<Node>& node : nodes)
 		node->render(cameraToScreen, deltaTime);
+	for (const std::function<void(const Camera&)>& batchRender : batchRenderFuncs)
+		batchRender(cameraToScreen);
 	
 	// Swaps the buffers/uses the swapchain to display output
 #ifdef KALE_OPENGL
@@ -221,37 +429,344 @@ void Scene::render(float deltaTime) const {
 }
 
 /**
- * Updates the current scene
- * @param threadNum the index of this thread, ranged 0 - numUpdateThreads
- * @param deltaTime The time the last frame has taken to update and render
+ * Snapshots the render state of the scene and all of its nodes, MUST be called on the main thread while no updates are running
  */
-void Scene::update(size_t threadNum, float deltaTime) {
+void Scene::takeRenderSnapshots() {
+	previousSnapshotCamera = renderSnapshotTaken ? snapshotCamera : camera;
+	snapshotCamera = camera;
+	renderSnapshotTaken = true;
+	renderCamera = camera;
+	renderBgColor = bgColor;
+	for (const std::shared_ptr<Node>& node : nodes) node->takeRenderSnapshot();
+}
+
+/**
+ * Blends the last two render snapshots of the scene and all of its nodes, MUST be called on the main thread prior to rendering
+ * @param alpha How far between the previous (0) and current (1) snapshot the rendered frame lies
+ */
+void Scene::interpolateRenderSnapshots(float alpha) {
+	renderCamera = previousSnapshotCamera * (1.0f - alpha) + snapshotCamera * alpha;
+	for (const std::shared_ptr<Node>& node : nodes) node->interpolateRenderSnapshot(alpha);
+}
+
+/**
+ * Splits the per thread node lists of a phase into chunks, leaving out nodes with awake dependencies
+ * @param phase The phase to split
+ */
+void Scene::buildChunks(UpdatePhase& phase) const {
 	
-	// Pre updating
-	onPreUpdate(threadNum, deltaTime);
-	for (std::shared_ptr<Node>& node : preUpdateNodes[threadNum]) node->preUpdate(threadNum, *this, deltaTime);
+	phase.chunks.clear();
+
+	// Nodes with awake dependencies are released by their dependencies rather than run within a chunk, so they add no time to chunks
+	const auto nodeTime = [&](const Node& node) -> float {
+		return node.numAwakeDependencies == 0 ? node.*phase.averageTime : 0.0f;
+	};
+
+	// Target an even split of the total time across all chunks
+	float totalTime = 0.0f;
+	for (const std::vector<Node*>& threadNodes : phase.nodes)
+		for (const Node* node : threadNodes) totalTime += nodeTime(*node);
+	float targetTime = totalTime / static_cast<float>(phase.nodes.size() * chunksPerThread);
+
+	// Split each thread's list into contiguous chunks of roughly the target time
+	for (size_t thread = 0; thread < phase.nodes.size(); thread++) {
+		size_t begin = 0;
+		float chunkTime = 0.0f;
+		for (size_t i = 0; i < phase.nodes[thread].size(); i++) {
+			chunkTime += nodeTime(*phase.nodes[thread][i]);
+			if (chunkTime < targetTime) continue;
+			phase.chunks.push_back(NodeChunk{thread, begin, i + 1});
+			begin = i + 1;
+			chunkTime = 0.0f;
+		}
+		if (begin != phase.nodes[thread].size()) phase.chunks.push_back(NodeChunk{thread, begin, phase.nodes[thread].size()});
+	}
+}
+
+/**
+ * Reassigns nodes to threads with the longest processing time first heuristic if the measured imbalance between threads
+ * exceeds balanceThreshold. MUST be called on the main thread while no updates are running.
+ * @param phase The phase to balance
+ * @returns The total measured time of each thread after balancing
+ */
+std::vector<float> Scene::balanceNodes(UpdatePhase& phase) {
 	
-	// mark pre updating as done & notify other threads if necessary
-	{
-		std::unique_lock lock(nodePreUpdateMutex);
-		nodesPreUpdated--;
-		size_t localGeneration = generation;
-		if (nodesPreUpdated == 0) {
-			generation++;
-			nodesPreUpdated = mainApp->getNumUpdateThreads();
-			nodePreUpdateCondVar.notify_all();
+	// Sum up the measured times of each thread
+	std::vector<float> times(phase.nodes.size(), 0.0f);
+	for (size_t thread = 0; thread < phase.nodes.size(); thread++)
+		for (const Node* node : phase.nodes[thread]) times[thread] += node->*phase.averageTime;
+
+	// Check whether or not the busiest thread exceeds the mean by more than the threshold
+	float mean = std::accumulate(times.begin(), times.end(), 0.0f) / static_cast<float>(times.size());
+	float busiest = *std::max_element(times.begin(), times.end());
+	if (mean <= 0.0f || busiest <= mean * (1.0f + balanceThreshold)) return times;
+
+	// Gather all the nodes and sort them from the longest to shortest time
+	std::vector<Node*> sortedNodes;
+	for (std::vector<Node*>& threadNodes : phase.nodes) {
+		sortedNodes.insert(sortedNodes.end(), threadNodes.begin(), threadNodes.end());
+		threadNodes.clear();
+	}
+	std::stable_sort(sortedNodes.begin(), sortedNodes.end(), [&](const Node* a, const Node* b) -> bool {
+		return a->*phase.averageTime > b->*phase.averageTime;
+	});
+
+	// Assign each node to the thread with the current smallest total time
+	std::fill(times.begin(), times.end(), 0.0f);
+	for (Node* node : sortedNodes) {
+		size_t thread = std::distance(times.begin(), std::min_element(times.begin(), times.end()));
+		times[thread] += node->*phase.averageTime;
+		assignNode(phase, node, thread);
+	}
+
+	return times;
+}
+
+/**
+ * Links every node to the nodes depending on it, ignoring the dependencies of any node in or behind a dependency cycle.
+ * MUST be called on the main thread while no updates are running.
+ */
+void Scene::buildDependencyGraph() {
+
+	// Clear the previous graph
+	for (const std::shared_ptr<Node>& node : nodes) {
+		node->dependents.clear();
+		node->numDependencies = 0;
+	}
+	dependentNodes.clear();
+
+	// Link every node to its dependencies, dependencies which aren't held in this scene are never run so they are skipped
+	for (const std::shared_ptr<Node>& node : nodes) {
+		for (Node* dependency : node->getUpdateDependencies()) {
+			if (dependency == nullptr || dependency == node.get()) continue;
+			const std::shared_ptr<Node>* held = nodes.get(dependency->sceneHandle);
+			if (held == nullptr || held->get() != dependency) continue;
+			dependency->dependents.push_back(node.get());
+			node->numDependencies++;
+		}
+	}
+
+	// Walk the graph from the nodes without dependencies, any node never reached is in or behind a cycle and would never be released
+	std::vector<Node*> released;
+	for (const std::shared_ptr<Node>& node : nodes) {
+		node->pendingUpdateDependencies.store(node->numDependencies, std::memory_order_relaxed);
+		if (node->numDependencies == 0) released.push_back(node.get());
+	}
+	while (!released.empty()) {
+		Node* node = released.back();
+		released.pop_back();
+		for (Node* dependent : node->dependents)
+			if (dependent->pendingUpdateDependencies.fetch_sub(1, std::memory_order_relaxed) == 1) released.push_back(dependent);
+	}
+
+	// Drop the dependencies of the unreached nodes so they are run within chunks like any other node
+	bool cycleFound = false;
+	for (const std::shared_ptr<Node>& node : nodes) {
+		if (node->pendingUpdateDependencies.load(std::memory_order_relaxed) == 0) continue;
+		node->numDependencies = 0;
+		cycleFound = true;
+	}
+	if (cycleFound) {
+		console.warn("Node dependency cycle found, the dependencies of nodes in or behind the cycle are ignored");
+		for (const std::shared_ptr<Node>& node : nodes)
+			std::erase_if(node->dependents, [](const Node* dependent) -> bool { return dependent->numDependencies == 0; });
+	}
+
+	// Only awake dependencies are waited on, sleeping nodes are never run
+	for (const std::shared_ptr<Node>& node : nodes) {
+		node->numAwakeDependencies = 0;
+		if (node->numDependencies != 0) dependentNodes.push_back(node.get());
+	}
+	for (const std::shared_ptr<Node>& node : nodes)
+		if (!node->sleeping) for (Node* dependent : node->dependents) dependent->numAwakeDependencies++;
+}
+
+/**
+ * Wakes the nodes due this frame & fills the per thread deques with each thread's chunks for the upcoming frame, MUST be called
+ * on the main thread prior to the update threads being released.
+ * @param deltaTime The time the upcoming frame updates by
+ */
+void Scene::scheduleUpdates(float deltaTime) {
+
+	// Advance the scene time to the end of this frame, waking the deferred nodes which fall due by then
+	sceneTime += deltaTime;
+	nodeTimers.advance(static_cast<uint64_t>(sceneTime / timerResolution), [&](std::pair<SlotHandle, uint32_t> timer) {
+		std::shared_ptr<Node>* node = nodes.get(timer.first);
+		if (node != nullptr && (*node)->sleeping && (*node)->timerGeneration == timer.second) wakeNode(node->get());
+	});
+
+	// Find the world space bounds of the view, the scene bounds are in camera space
+	Vector2f viewMin = camera.inverseTransform(sceneBounds.topLeft);
+	Vector2f viewMax = viewMin;
+	for (const Vector2f& corner : {sceneBounds.topRight(), sceneBounds.bottomLeft(), sceneBounds.bottomRight}) {
+		Vector2f point = camera.inverseTransform(corner);
+		viewMin = Vector2f(std::min(viewMin.x, point.x), std::min(viewMin.y, point.y));
+		viewMax = Vector2f(std::max(viewMax.x, point.x), std::max(viewMax.y, point.y));
+	}
+	viewBounds = Rect({viewMin.x, viewMax.y}, {viewMax.x, viewMin.y});
+
+	// Wake the level of detail deferred nodes which have moved into a nearer tier, such as nodes scrolled into view. Nodes which
+	// have since woken or been removed are dropped.
+	std::erase_if(lodDeferredNodes, [&](std::pair<SlotHandle, uint32_t> deferred) -> bool {
+		std::shared_ptr<Node>* node = nodes.get(deferred.first);
+		if (node == nullptr || !(*node)->sleeping || (*node)->timerGeneration != deferred.second) return true;
+		if (getUpdateLODInterval((*node)->lodBounds) >= (*node)->sleepDelay) return false;
+		wakeNode(node->get());
+		return true;
+	});
+
+	// Periodically rebalance the threads based off of the measured node times
+	if (++framesSinceBalanceCheck >= balanceInterval) {
+		framesSinceBalanceCheck = 0;
+		std::vector<float> updateTimes = balanceNodes(updatePhase);
+		std::vector<float> preUpdateTimes = balanceNodes(preUpdatePhase);
+		for (size_t i = 0; i < threadedNodePerformanceTimes.size(); i++)
+			threadedNodePerformanceTimes[i] = std::make_pair(updateTimes[i], preUpdateTimes[i]);
+		chunksOutdated = true;
+	}
+
+	// Rebuild the chunks if the node structures or the awake nodes have changed
+	if (chunksOutdated) {
+		scheduledDependentNodes.clear();
+		for (Node* node : dependentNodes)
+			if (!node->sleeping && node->numAwakeDependencies != 0) scheduledDependentNodes.push_back(node);
+		buildChunks(updatePhase);
+		buildChunks(preUpdatePhase);
+		chunksOutdated = false;
+	}
+
+	// Refill the deques, chunks are pushed in reverse so each thread pops its own nodes in order while thieves steal from the back.
+	// Every dependent node is waited on as well, as each is pushed to a ready deque once its dependencies finish.
+	const auto fillQueues = [&](UpdatePhase& phase) {
+		for (const std::unique_ptr<WorkStealingDeque<uint32_t>>& queue : phase.queues) queue->reserve(phase.chunks.size());
+		for (size_t i = phase.chunks.size(); i-- > 0;) phase.queues[phase.chunks[i].thread]->push(static_cast<uint32_t>(i));
+		for (const std::unique_ptr<WorkStealingDeque<Node*>>& queue : phase.readyQueues) queue->reserve(scheduledDependentNodes.size());
+		for (Node* node : scheduledDependentNodes)
+			(node->*phase.pendingDependencies).store(node->numAwakeDependencies, std::memory_order_relaxed);
+		phase.remaining.store(phase.chunks.size() + scheduledDependentNodes.size(), std::memory_order_relaxed);
+	};
+
+	fillQueues(updatePhase);
+	fillQueues(preUpdatePhase);
+}
+
+/**
+ * Runs the chunks within this thread's deque and the nodes this thread has released, then steals from other threads until
+ * no work remains. Every node is passed the time since its own last update.
+ * @param phase The phase to run
+ * @param threadNum The index of this thread
+ */
+void Scene::runChunks(UpdatePhase& phase, size_t threadNum) {
+
+	// Runs a node, folding its time into its moving average and releasing any awake dependents which were only waiting on it. A
+	// failing node is logged and still releases its dependents, as every other thread waits until every node has run.
+	const auto runNode = [&](Node& node, std::chrono::steady_clock::time_point& previousTime) {
+		try {
+			float nodeDeltaTime = static_cast<float>(sceneTime - node.lastUpdateTime);
+			(node.*phase.func)(threadNum, *this, nodeDeltaTime);
+
+			// Once both phases have run, behaviors are resumed on this thread. Nodes with nothing to simulate then sleep until woken
+			// or their next behavior is due, and deferred nodes sleep until due.
+			if (&phase == &updatePhase) {
+				node.lastUpdateTime = sceneTime;
+				float behaviorDelay = node.runBehaviors(nodeDeltaTime);
+				float delay = node.nextUpdateDelay >= 0.0f ? node.nextUpdateDelay : node.updateInterval;
+				if (node.nextUpdateDelay < 0.0f) node.lodDeferred = false;
+				node.nextUpdateDelay = -1.0f;
+				if (node.isDormant()) {
+					node.sleepDelay = std::isinf(behaviorDelay) ? 0.0f : behaviorDelay;
+					node.lodDeferred = false;
+					if (behaviorDelay > 0.0f) idleNodes[threadNum].push_back(&node);
+				}
+				else {
+					node.sleepDelay = std::min(delay, behaviorDelay);
+					if (node.sleepDelay > 0.0f) idleNodes[threadNum].push_back(&node);
+				}
+			}
 		}
-		else {
-			nodePreUpdateCondVar.wait(lock, [&]() -> bool { return localGeneration != generation; });
+		catch (const std::exception& e) {
+			console.error("Failed to update node on update thread " + std::to_string(threadNum) + " - " + e.what());
+		}
+		
+		auto currentTime = std::chrono::steady_clock::now();
+		float time = std::chrono::duration<float, std::micro>(currentTime - previousTime).count();
+		node.*phase.averageTime += (time - node.*phase.averageTime) * nodeTimeSmoothing;
+		previousTime = currentTime;
+
+		for (Node* dependent : node.dependents)
+			if (!dependent->sleeping && (dependent->*phase.pendingDependencies).fetch_sub(1, std::memory_order_acq_rel) == 1)
+				phase.readyQueues[threadNum]->push(dependent);
+	};
+
+	// Runs every node in a chunk besides the nodes waiting on awake dependencies
+	const auto runChunk = [&](uint32_t index) {
+		const NodeChunk& chunk = phase.chunks[index];
+		auto previousTime = std::chrono::steady_clock::now();
+		for (size_t i = chunk.begin; i < chunk.end; i++)
+			if (phase.nodes[chunk.thread][i]->numAwakeDependencies == 0) runNode(*phase.nodes[chunk.thread][i], previousTime);
+		phase.remaining.fetch_sub(1, std::memory_order_release);
+	};
+
+	// Runs a dependent node released by its dependencies
+	const auto runReadyNode = [&](Node* node) {
+		auto previousTime = std::chrono::steady_clock::now();
+		runNode(*node, previousTime);
+		phase.remaining.fetch_sub(1, std::memory_order_release);
+	};
+
+	// Steals a single released node or chunk from the other threads
+	const auto steal = [&]() -> bool {
+		for (size_t i = 1; i < phase.queues.size(); i++) {
+			size_t victim = (threadNum + i) % phase.queues.size();
+			if (std::optional<Node*> node = phase.readyQueues[victim]->steal()) {
+				runReadyNode(*node);
+				return true;
+			}
+			if (std::optional<uint32_t> index = phase.queues[victim]->steal()) {
+				runChunk(*index);
+				return true;
+			}
 		}
+		return false;
+	};
+
+	// Work through the nodes we've released and our own chunks first, then steal from the other threads until everything has finished,
+	// helping with any jobs nodes have spawned in the meantime
+	while (phase.remaining.load(std::memory_order_acquire) != 0) {
+		if (std::optional<Node*> node = phase.readyQueues[threadNum]->pop()) runReadyNode(*node);
+		else if (std::optional<uint32_t> index = phase.queues[threadNum]->pop()) runChunk(*index);
+		else if (!steal() && !jobSystem.runPendingJob()) std::this_thread::yield();
 	}
+}
 
-	// notify other threads if applicable
-	if (nodesPreUpdated == mainApp->getNumUpdateThreads()) nodePreUpdateCondVar.notify_all();
+/**
+ * Updates the current scene
+ * @param threadNum the index of this thread, ranged 0 - numUpdateThreads
+ * @param deltaTime The time the last frame has taken to update and render
+ */
+void Scene::update(size_t threadNum, float deltaTime) {
+	
+	// Pre updating, a failure outside of the nodes must not keep this thread from the barrier every other thread waits at
+	JobSystem::setCurrentThread(threadNum);
+	try {
+		onPreUpdate(threadNum, deltaTime);
+	}
+	catch (const std::exception& e) {
+		console.error("Failed to pre update scene on update thread " + std::to_string(threadNum) + " - " + e.what());
+	}
+	runChunks(preUpdatePhase, threadNum);
+	
+	// Wait for every thread to finish pre updating
+	preUpdateBarrier.arriveAndWait();
 
 	// Updating
-	onUpdate(threadNum, deltaTime);
-	for (std::shared_ptr<Node>& node : updateNodes[threadNum]) node->update(threadNum, *this, deltaTime);
+	try {
+		onUpdate(threadNum, deltaTime);
+	}
+	catch (const std::exception& e) {
+		console.error("Failed to update scene on update thread " + std::to_string(threadNum) + " - " + e.what());
+	}
+	runChunks(updatePhase, threadNum);
 }
 
 /**
@@ -291,11 +806,28 @@ void Scene::onSceneChange() {
 }
 
 /**
- * Gets the ndoes within the scene
+ * Gets the loader of the scene file, used to show loading progress or wait for the scene to load
+ * @returns The loader, nullptr if the scene was not constructed from a file
+ */
+std::shared_ptr<const SceneLoader> Scene::getLoader() const {
+	return loader;
+}
+
+/**
+ * Gets the ndoes within the scene, contiguous but in no guaranteed order
  * @returns The nodes
  */
-const std::list<std::shared_ptr<Node>>& Scene::getNodes() const {
-	return nodes;
+const std::vector<std::shared_ptr<Node>>& Scene::getNodes() const {
+	return nodes.getValues();
+}
+
+/**
+ * Gets the total measured update and pre update times of the nodes assigned to each thread, as of the last balance check.
+ * Individual node times can be retrieved via Node::getAverageUpdateTime and Node::getAveragePreUpdateTime.
+ * @returns A vector with a pair of the update and pre update time in microseconds for each thread
+ */
+const std::vector<std::pair<float, float>>& Scene::getThreadPerformanceTimes() const {
+	return threadedNodePerformanceTimes;
 }
 
 /**
@@ -306,6 +838,15 @@ Color Scene::getBgColor() const {
 	return bgColor;
 }
 
+/**
+ * Gets the job system, used by nodes to split their own work across the update threads via JobSystem::parallelFor or
+ * TaskGroup. Jobs may only be spawned during pre updating or updating and must be joined before returning.
+ * @returns The job system
+ */
+JobSystem& Scene::getJobSystem() const {
+	return jobSystem;
+}
+
 /**
  * Gets the camera used to render this scene
  * @returns The camera
@@ -330,3 +871,20 @@ Vector2f Scene::getViewport() const {
 Rect Scene::getSceneBounds() const {
 	return sceneBounds;
 }
+
+/**
+ * Gets the interval a node should animate at given its bounding box, per the update level of detail tiers. Nodes can defer their
+ * next update by this interval via Node::scheduleNextUpdate, catching up on the skipped time once they next update.
+ * @param boundingBox The world space bounding box of the node
+ * @returns The interval in microseconds, 0 if the node is on or near the screen and should update every frame
+ */
+float Scene::getUpdateLODInterval(const Rect& boundingBox) const {
+	float distance = std::max({
+		viewBounds.topLeft.x - boundingBox.bottomRight.x, boundingBox.topLeft.x - viewBounds.bottomRight.x,
+		viewBounds.bottomRight.y - boundingBox.topLeft.y, boundingBox.bottomRight.y - viewBounds.topLeft.y
+	});
+
+	for (size_t i = updateLODTiers.size(); i-- > 0;)
+		if (distance >= updateLODTiers[i].first) return updateLODTiers[i].second;
+	return 0.0f;
+}
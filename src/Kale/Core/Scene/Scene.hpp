@@ -19,14 +19,24 @@
 #include <Kale/Engine/Node/Node.hpp>
 #include <Kale/Core/Events/Events.hpp>
 #include <Kale/Math/Transform/Transform.hpp>
+#include <Kale/Core/Barrier/Barrier.hpp>
+#include <Kale/Core/SlotMap/SlotMap.hpp>
+#include <Kale/Core/MPSCQueue/MPSCQueue.hpp>
+#include <Kale/Core/JobSystem/JobSystem.hpp>
+#include <Kale/Core/WorkStealingDeque/WorkStealingDeque.hpp>
+#include <Kale/Core/TimerWheel/TimerWheel.hpp>
+#include <Kale/Core/FrameRecorder/FrameRecorder.hpp>
+#include <Kale/Core/SceneLoader/SceneLoader.hpp>
+#include <Kale/Core/BinaryScene/BinaryScene.hpp>
 
-#include <list>
 #include <vector>
-#include <queue>
 #include <utility>
 #include <memory>
+#include <atomic>
 #include <mutex>
-#include <condition_variable>
+#include <cstdint>
+#include <chrono>
+#include <deque>
 
 #include <nlohmann/json.hpp>
 
@@ -45,6 +55,106 @@ namespace Kale {
 	class Scene : public EventHandler {
 	private:
 
+		/**
+		 * A contiguous range of nodes within a single thread's update list, the unit of work which update threads can steal
+		 * from one another
+		 */
+		struct NodeChunk {
+
+			/**
+			 * The index of the thread whose list holds the nodes of this chunk
+			 */
+			size_t thread;
+
+			/**
+			 * The index of the first node within the thread's list
+			 */
+			size_t begin;
+
+			/**
+			 * The index past the last node within the thread's list
+			 */
+			size_t end;
+		};
+
+		/**
+		 * The scheduling state of a single phase of node updates, either pre updating or updating
+		 */
+		struct UpdatePhase {
+
+			/**
+			 * Stores the nodes by their thread, each node holds its own location within these lists
+			 */
+			std::vector<std::vector<Node*>> nodes;
+
+			/**
+			 * The chunks of nodes, rebuilt whenever the node structures change
+			 */
+			std::vector<NodeChunk> chunks;
+
+			/**
+			 * Per thread deques of indices into chunks. Each thread works through its own deque and steals from others when empty.
+			 */
+			std::vector<std::unique_ptr<WorkStealingDeque<uint32_t>>> queues;
+
+			/**
+			 * Per thread deques of nodes whose dependencies have all finished this frame, pushed by the thread which ran the last dependency
+			 */
+			std::vector<std::unique_ptr<WorkStealingDeque<Node*>>> readyQueues;
+
+			/**
+			 * The number of chunks and dependent nodes yet to finish this frame, threads help with jobs until this reaches zero
+			 */
+			std::atomic<size_t> remaining;
+
+			/**
+			 * The node function called on every node during this phase
+			 */
+			void (Node::*func)(size_t, const Scene&, float);
+
+			/**
+			 * The node's measured average time member for this phase
+			 */
+			float Node::*averageTime;
+
+			/**
+			 * The node's location member for this phase's lists
+			 */
+			std::pair<size_t, size_t> Node::*location;
+
+			/**
+			 * The node's counter of dependencies yet to finish this phase
+			 */
+			std::atomic<uint32_t> Node::*pendingDependencies;
+
+			/**
+			 * Creates the scheduling state of a phase
+			 * @param func The node function called on every node during this phase
+			 * @param averageTime The node's measured average time member for this phase
+			 * @param location The node's location member for this phase's lists
+			 * @param pendingDependencies The node's counter of dependencies yet to finish this phase
+			 * @param numThreads The number of update threads
+			 */
+			UpdatePhase(void (Node::*func)(size_t, const Scene&, float), float Node::*averageTime, std::pair<size_t, size_t> Node::*location,
+				std::atomic<uint32_t> Node::*pendingDependencies, size_t numThreads);
+		};
+
+		/**
+		 * The number of chunks each thread's nodes are targeted to be split into, more chunks allow for finer stealing
+		 * at the cost of more scheduling overhead
+		 */
+		static constexpr size_t chunksPerThread = 4;
+
+		/**
+		 * The duration in microseconds of a single tick of the node timers
+		 */
+		static constexpr float timerResolution = 1000.0f;
+
+		/**
+		 * The weight of the newest measurement in the exponential moving average of node update times
+		 */
+		static constexpr float nodeTimeSmoothing = 0.1f;
+
 		/**
 		 * A map of strings to a constructor taking a JSON to initialize a node. All nodes capable of save states must be present in this
 		 * map prior to the first scene's presentation. The best way to do this is via a node setup function, which can be added from
@@ -53,19 +163,73 @@ namespace Kale {
 		inline static std::unordered_map<std::string, std::function<std::shared_ptr<Node>(JSON)>> nodeMap;
 
 		/**
-		 * A list of all the nodes to be presented in the current scene
+		 * A map of strings to the constructor reading a node from a binary scene and the function writing a node to a binary scene,
+		 * keyed the same as the node map. Populated alongside the node map by node setup functions.
+		 */
+		inline static std::unordered_map<std::string, std::pair<std::function<std::shared_ptr<Node>(BinarySceneReader&)>,
+			std::function<void(const Node&, BinarySceneWriter&)>>> binaryNodeMap;
+
+		/**
+		 * Functions called once every node has rendered, drawing the nodes which batch their rendering together rather than
+		 * drawing within Node::render. Populated by node setup functions.
+		 */
+		inline static std::vector<std::function<void(const Camera&)>> batchRenderFuncs;
+
+		/**
+		 * The registry of all the nodes to be presented in the current scene, holding them contiguously with O(1) removal
+		 */
+		SlotMap<std::shared_ptr<Node>> nodes;
+
+		/**
+		 * The pre updating phase of the scene
+		 */
+		UpdatePhase preUpdatePhase;
+
+		/**
+		 * The updating phase of the scene
+		 */
+		UpdatePhase updatePhase;
+
+		/**
+		 * The nodes which depend on other nodes within the scene, rebuilt along with the dependency graph
+		 */
+		std::vector<Node*> dependentNodes;
+
+		/**
+		 * The awake nodes with awake dependencies, these are run once released by their dependencies rather than within chunks
+		 */
+		std::vector<Node*> scheduledDependentNodes;
+
+		/**
+		 * Whether or not the chunks need to be rebuilt prior to the next update
 		 */
-		std::list<std::shared_ptr<Node>> nodes;
+		bool chunksOutdated;
 
 		/**
-		 * Stores the nodes to be updated by their update thread
+		 * The nodes found dormant or deferred after updating by each thread, put to sleep when the node structures are next updated
 		 */
-		std::vector<std::list<std::shared_ptr<Node>>> updateNodes;
+		std::vector<std::vector<Node*>> idleNodes;
 
 		/**
-		 * Stores the nodes to be pre updated by their pre update thread
+		 * The timers of the nodes sleeping until their next update, holding each node's handle & timer generation
 		 */
-		std::vector<std::list<std::shared_ptr<Node>>> preUpdateNodes;
+		TimerWheel<std::pair<SlotHandle, uint32_t>> nodeTimers;
+
+		/**
+		 * The nodes sleeping on a level of detail deferral, holding each node's handle & timer generation. These are woken early
+		 * once their bounds fall into a nearer level of detail tier.
+		 */
+		std::vector<std::pair<SlotHandle, uint32_t>> lodDeferredNodes;
+
+		/**
+		 * The total time in microseconds the scene has been updated for, up to the end of the current update
+		 */
+		double sceneTime;
+
+		/**
+		 * The job system nodes can spawn jobs in during pre updating and updating
+		 */
+		mutable JobSystem jobSystem;
 
 		/**
 		 * Holds the sum of the update times and pre update times of each set per thread
@@ -73,39 +237,79 @@ namespace Kale {
 		std::vector<std::pair<float, float>> threadedNodePerformanceTimes;
 
 		/**
-		 * A queue of nodes to add
+		 * The number of frames scheduled since the thread balance was last checked
 		 */
-		std::queue<std::shared_ptr<Node>> nodesToAdd;
+		size_t framesSinceBalanceCheck;
 
 		/**
-		 * A queue of nodes to remove
+		 * The nodes to add, batched until the node structures are next updated
 		 */
-		std::queue<std::shared_ptr<Node>> nodesToRemove;
+		MPSCQueue<std::shared_ptr<Node>> nodesToAdd;
 
 		/**
-		 * The mutex used for adding/removing nodes safety
+		 * The nodes to remove, batched until the node structures are next updated
 		 */
-		std::mutex nodeQueueUpdateMutex;
+		MPSCQueue<std::shared_ptr<Node>> nodesToRemove;
+
+		/**
+		 * The handles of the sleeping nodes to wake, batched until the node structures are next updated
+		 */
+		MPSCQueue<SlotHandle> nodesToWake;
+
+		/**
+		 * The nodes taken from the queues to add which ran past the deadline, added first in later frames
+		 */
+		std::deque<std::shared_ptr<Node>> carriedNodesToAdd;
+
+		/**
+		 * The nodes added & removed by the last call to updateNodeStructures, recorded and checked by the frame recorder
+		 */
+		FrameRecorder::StructureChange lastStructureChange;
+
+		/**
+		 * Loads the nodes of the scene file in the background when constructed from a file, nullptr otherwise
+		 */
+		std::shared_ptr<SceneLoader> loader;
+
+		/**
+		 * The nodes constructed by the loader which are yet to be begun, added behind any other nodes
+		 */
+		std::deque<std::shared_ptr<Node>> loadedNodesToAdd;
 
 		/**
-		 * Mutex used for syncrhonizing pre updates
+		 * The nodes to add which were queued while nodesToAdd was full
 		 */
-		std::mutex nodePreUpdateMutex;
+		std::vector<std::shared_ptr<Node>> overflowNodesToAdd;
 
 		/**
-		 * Condition variable to check if threads have completed pre updating
+		 * The nodes to remove which were queued while nodesToRemove was full
 		 */
-		std::condition_variable nodePreUpdateCondVar;
+		std::vector<std::shared_ptr<Node>> overflowNodesToRemove;
 
 		/**
-		 * The count of nodes which have pre updated
+		 * Whether or not overflowNodesToAdd holds nodes, nodes are then queued behind them so each thread's nodes keep their order
 		 */
-		size_t nodesPreUpdated;
+		std::atomic<bool> nodesToAddOverflowed = false;
 
 		/**
-		 * The count of frames used for thread synchronization
+		 * Whether or not overflowNodesToRemove holds nodes, nodes are then queued behind them so each thread's nodes keep their order
 		 */
-		size_t generation;
+		std::atomic<bool> nodesToRemoveOverflowed = false;
+
+		/**
+		 * The handles of the nodes to wake which were queued while nodesToWake was full
+		 */
+		std::vector<SlotHandle> overflowNodesToWake;
+
+		/**
+		 * The mutex used for accessing the overflow node queues
+		 */
+		std::mutex nodeQueueUpdateMutex;
+
+		/**
+		 * Barrier used for synchronizing the update threads between pre updating and updating
+		 */
+		Barrier preUpdateBarrier;
 
 		/**
 		 * The world to screen transformation matrix. Used internally for rendering and converting
@@ -114,11 +318,52 @@ namespace Kale {
 		Transform worldToScreen;
 
 		/**
-		 * Renders the current scene
+		 * The camera as of the last render snapshot
+		 */
+		Camera snapshotCamera;
+
+		/**
+		 * The camera as of the render snapshot prior to the last
+		 */
+		Camera previousSnapshotCamera;
+
+		/**
+		 * The camera used for rendering, either the snapshot camera or an interpolation of the last two
+		 */
+		Camera renderCamera;
+
+		/**
+		 * Whether or not a render snapshot has been taken yet
+		 */
+		bool renderSnapshotTaken = false;
+
+		/**
+		 * The world space bounds of the camera's view for the current frame, used for update level of detail
+		 */
+		Rect viewBounds;
+
+		/**
+		 * The background color as of the last render snapshot
+		 */
+		Vector4f renderBgColor;
+
+		/**
+		 * Renders the current scene from the last render snapshot
 		 * @param deltaTime The time the last frame has taken to update and render
 		 */
 		void render(float deltaTime) const;
 
+		/**
+		 * Snapshots the render state of the scene and all of its nodes, MUST be called on the main thread while no updates are running
+		 */
+		void takeRenderSnapshots();
+
+		/**
+		 * Blends the last two render snapshots of the scene and all of its nodes, MUST be called on the main thread prior to rendering
+		 * @param alpha How far between the previous (0) and current (1) snapshot the rendered frame lies
+		 */
+		void interpolateRenderSnapshots(float alpha);
+
 		/**
 		 * Updates the current scene
 		 * @param threadNum the index of this thread, ranged 0 - numUpdateThreads
@@ -128,12 +373,123 @@ namespace Kale {
 
 		/**
 		 * Updates the data structures holding nodes based off of the queues, MUST be called on the main thread
-		 * after the completion of all updates in the frame.
+		 * after the completion of all updates in the frame. Nodes are added until the deadline passes, the rest are carried over.
+		 * @param deadline The time to stop beginning added nodes at, at least one node is always added
+		 */
+		void updateNodeStructures(std::chrono::steady_clock::time_point deadline);
+
+		/**
+		 * Queues a node to be added or removed, falling back to the overflow list if the queue is full. Can be called on any thread.
+		 * Nodes queued by one thread, or otherwise queued one after another, are taken in the order queued. Nodes queued concurrently
+		 * by different threads have no defined order.
+		 * @param queue The queue to push the node to
+		 * @param overflow The list to push the node to if the queue is full
+		 * @param overflowed Whether or not the overflow list holds nodes
+		 * @param node The node to queue
+		 */
+		void queueNode(MPSCQueue<std::shared_ptr<Node>>& queue, std::vector<std::shared_ptr<Node>>& overflow, std::atomic<bool>& overflowed,
+			std::shared_ptr<Node> node);
+
+		/**
+		 * Takes all the nodes queued in a queue and its overflow list, MUST be called on the main thread
+		 * @param queue The queue to take nodes from
+		 * @param overflow The overflow list to take nodes from
+		 * @param overflowed Whether or not the overflow list holds nodes
+		 * @returns The queued nodes
+		 */
+		std::vector<std::shared_ptr<Node>> takeQueuedNodes(MPSCQueue<std::shared_ptr<Node>>& queue,
+			std::vector<std::shared_ptr<Node>>& overflow, std::atomic<bool>& overflowed);
+
+		/**
+		 * Queues a sleeping node to be woken, falling back to the overflow list if the queue is full. Can be called on the main thread or
+		 * any update thread.
+		 * @param handle The handle of the node to wake
+		 */
+		void queueWake(SlotHandle handle);
+
+		/**
+		 * Wakes the queued nodes & puts the idle nodes to sleep, MUST be called on the main thread after the completion of all updates
+		 * in the frame.
+		 */
+		void updateActiveNodes();
+
+		/**
+		 * Wakes a node and every node depending on it, adding the sleeping nodes back into both phases
+		 * @param node The node to wake
 		 */
-		void updateNodeStructures();
+		void wakeNode(Node* node);
+
+		/**
+		 * Puts a node to sleep, removing it from both phases & invalidating its previous timer
+		 * @param node The node to put to sleep
+		 */
+		void sleepNode(Node* node);
+
+		/**
+		 * Assigns a node to the threads with the smallest total pre update and update times
+		 * @param node The node to assign
+		 */
+		void activateNode(Node* node);
+
+		/**
+		 * Removes a node from both phases and from the total times of its threads
+		 * @param node The node to remove
+		 */
+		void deactivateNode(Node* node);
+
+		/**
+		 * Appends a node to a thread's list and stores its location within the node
+		 * @param phase The phase whose lists to append the node to
+		 * @param node The node to append
+		 * @param thread The thread to append the node to
+		 */
+		static void assignNode(UpdatePhase& phase, Node* node, size_t thread);
+
+		/**
+		 * Removes a node from its thread's list in constant time by moving the last node of the list into its place
+		 * @param phase The phase whose lists to remove the node from
+		 * @param node The node to remove
+		 */
+		static void unassignNode(UpdatePhase& phase, Node* node);
+
+		/**
+		 * Splits the per thread node lists of a phase into chunks, leaving out nodes with awake dependencies
+		 * @param phase The phase to split
+		 */
+		void buildChunks(UpdatePhase& phase) const;
+
+		/**
+		 * Reassigns nodes to threads with the longest processing time first heuristic if the measured imbalance between threads
+		 * exceeds balanceThreshold. MUST be called on the main thread while no updates are running.
+		 * @param phase The phase to balance
+		 * @returns The total measured time of each thread after balancing
+		 */
+		std::vector<float> balanceNodes(UpdatePhase& phase);
+
+		/**
+		 * Links every node to the nodes depending on it, ignoring the dependencies of any node in or behind a dependency cycle.
+		 * MUST be called on the main thread while no updates are running.
+		 */
+		void buildDependencyGraph();
+
+		/**
+		 * Wakes the nodes due this frame & fills the per thread deques with each thread's chunks for the upcoming frame, MUST be called
+		 * on the main thread prior to the update threads being released.
+		 * @param deltaTime The time the upcoming frame updates by
+		 */
+		void scheduleUpdates(float deltaTime);
+
+		/**
+		 * Runs the chunks within this thread's deque and the nodes this thread has released, then steals from other threads until
+		 * no work remains. Every node is passed the time since its own last update.
+		 * @param phase The phase to run
+		 * @param threadNum The index of this thread
+		 */
+		void runChunks(UpdatePhase& phase, size_t threadNum);
 
 		friend class Application;
 		friend class Node;
+		friend class SceneLoader;
 
 	protected:
 
@@ -161,14 +517,37 @@ namespace Kale {
 		 */
 		Rect sceneBounds;
 
+		/**
+		 * The number of frames between checks of how evenly the measured node update times are spread across threads
+		 */
+		size_t balanceInterval = 60;
+
+		/**
+		 * The fraction the busiest thread may exceed the mean thread time by before nodes are reassigned to threads.
+		 * For example 0.25 allows the busiest thread to take 25% longer than the average thread before rebalancing.
+		 */
+		float balanceThreshold = 0.25f;
+
+		/**
+		 * The update level of detail tiers, pairs of the distance in world units a node's bounding box lies outside of the view and the
+		 * interval in microseconds such nodes animate at. Must be sorted by distance, nodes closer than the first tier update every frame.
+		 */
+		std::vector<std::pair<float, float>> updateLODTiers = {{540.0f, 100000.0f}, {2160.0f, 500000.0f}};
+
 		/**
 		 * Adds a node to the scene to render/update
 		 * @param node The node to add
 		 */
 		template <typename T> void addNode(std::shared_ptr<T>& node) {
-			std::shared_ptr<Kale::Node> nodePtr = std::dynamic_pointer_cast<Kale::Node>(node);
-			std::lock_guard guard(nodeQueueUpdateMutex);
-			nodesToAdd.push(nodePtr);
+			queueNode(nodesToAdd, overflowNodesToAdd, nodesToAddOverflowed, std::dynamic_pointer_cast<Kale::Node>(node));
+		}
+
+		/**
+		 * Adds a batch of nodes to the scene to render/update, all added together when the node structures are next updated
+		 * @param batch The nodes to add
+		 */
+		template <typename T> void addNodes(const std::vector<std::shared_ptr<T>>& batch) {
+			for (const std::shared_ptr<T>& node : batch) queueNode(nodesToAdd, overflowNodesToAdd, nodesToAddOverflowed, std::dynamic_pointer_cast<Kale::Node>(node));
 		}
 
 		/**
@@ -182,9 +561,15 @@ namespace Kale {
 		 * @param node The node to remove
 		 */
 		template <typename T> void removeNode(std::shared_ptr<T>& node) {
-			std::shared_ptr<Kale::Node> nodePtr = std::dynamic_pointer_cast<Kale::Node>(node);
-			std::lock_guard guard(nodeQueueUpdateMutex);
-			nodesToRemove.push(nodePtr);
+			queueNode(nodesToRemove, overflowNodesToRemove, nodesToRemoveOverflowed, std::dynamic_pointer_cast<Kale::Node>(node));
+		}
+
+		/**
+		 * Removes a batch of nodes from the scene, all removed together when the node structures are next updated
+		 * @param batch The nodes to remove
+		 */
+		template <typename T> void removeNodes(const std::vector<std::shared_ptr<T>>& batch) {
+			for (const std::shared_ptr<T>& node : batch) queueNode(nodesToRemove, overflowNodesToRemove, nodesToRemoveOverflowed, std::dynamic_pointer_cast<Kale::Node>(node));
 		}
 
 		/**
@@ -230,16 +615,35 @@ namespace Kale {
 		Scene();
 
 		/**
-		 * Constructs a new scene from a scene save file
+		 * Constructs a new scene from a scene save file. The file is loaded in the background, its nodes are added over the following
+		 * frames whether or not the scene is presented. Loading can be followed through Scene::getLoader.
 		 * @param filename The filename of the scene JSON file
 		 */
 		Scene(const std::string& filename);
 
 		/**
-		 * Gets the ndoes within the scene
+		 * Stops loading the scene file if still loading
+		 */
+		virtual ~Scene();
+
+		/**
+		 * Gets the loader of the scene file, used to show loading progress or wait for the scene to load
+		 * @returns The loader, nullptr if the scene was not constructed from a file
+		 */
+		std::shared_ptr<const SceneLoader> getLoader() const;
+
+		/**
+		 * Gets the ndoes within the scene, contiguous but in no guaranteed order
 		 * @returns The nodes
 		 */
-		const std::list<std::shared_ptr<Node>>& getNodes() const;
+		const std::vector<std::shared_ptr<Node>>& getNodes() const;
+
+		/**
+		 * Gets the total measured update and pre update times of the nodes assigned to each thread, as of the last balance check.
+		 * Individual node times can be retrieved via Node::getAverageUpdateTime and Node::getAveragePreUpdateTime.
+		 * @returns A vector with a pair of the update and pre update time in microseconds for each thread
+		 */
+		const std::vector<std::pair<float, float>>& getThreadPerformanceTimes() const;
 
 		/**
 		 * Gets the background color of the scene
@@ -247,6 +651,13 @@ namespace Kale {
 		 */
 		Color getBgColor() const;
 
+		/**
+		 * Gets the job system, used by nodes to split their own work across the update threads via JobSystem::parallelFor or
+		 * TaskGroup. Jobs may only be spawned during pre updating or updating and must be joined before returning.
+		 * @returns The job system
+		 */
+		JobSystem& getJobSystem() const;
+
 		/**
 		 * Gets the camera used to render this scene
 		 * @returns The camera
@@ -266,6 +677,14 @@ namespace Kale {
 		 */
 		Rect getSceneBounds() const;
 
+		/**
+		 * Gets the interval a node should animate at given its bounding box, per the update level of detail tiers. Nodes can defer their
+		 * next update by this interval via Node::scheduleNextUpdate, catching up on the skipped time once they next update.
+		 * @param boundingBox The world space bounding box of the node
+		 * @returns The interval in microseconds, 0 if the node is on or near the screen and should update every frame
+		 */
+		float getUpdateLODInterval(const Rect& boundingBox) const;
+
 		/**
 		 * Adds a node save state constructor to the map of nodes used for scene loading.
 		 * @param key The key used to identify this type of node
@@ -275,5 +694,24 @@ namespace Kale {
 			nodeMap[key] = constructor;
 		}
 
+		/**
+		 * Adds a function called each frame once every node has rendered, used by nodes which batch their rendering together
+		 * @param func The function drawing the batch, called with the camera to render with
+		 */
+		static void addBatchRenderFunction(std::function<void(const Camera&)> func) {
+			batchRenderFuncs.push_back(std::move(func));
+		}
+
+		/**
+		 * Adds the functions used for loading and converting to binary scenes for a type of node.
+		 * @param key The key used to identify this type of node, the same as its save state constructor's key
+		 * @param constructor The constructor used to create nodes from their binary record
+		 * @param writer The function used to write nodes to their binary record
+		 */
+		static void addNodeBinarySaveState(const std::string& key, std::function<std::shared_ptr<Node>(BinarySceneReader&)> constructor,
+			std::function<void(const Node&, BinarySceneWriter&)> writer) {
+			binaryNodeMap[key] = std::make_pair(constructor, writer);
+		}
+
 	};
 }
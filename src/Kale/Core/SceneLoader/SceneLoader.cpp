@@ -0,0 +1,481 @@
+/*
+   Copyright 2022 Rishi Challa
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+	   http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+
+#include "SceneLoader.hpp"
+
+#include <Kale/Core/Scene/Scene.hpp>
+#include <Kale/Core/Application/Application.hpp>
+#include <Kale/Core/Logger/Logger.hpp>
+#include <Kale/Core/MappedFile/MappedFile.hpp>
+#include <Kale/Core/BinaryScene/BinaryScene.hpp>
+#include <Kale/Core/SceneParser/SceneParser.hpp>
+
+#include <fstream>
+#include <iterator>
+#include <stdexcept>
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <functional>
+#include <optional>
+#include <string_view>
+
+using namespace Kale;
+
+/**
+ * The number of nodes constructed together by a worker thread and handed to the scene at once
+ */
+static constexpr size_t nodeBatchSize = 32;
+
+/**
+ * The number of batches per worker thread which may be in flight before parsing waits, bounding the memory held by the batches
+ */
+static constexpr size_t batchesInFlightPerWorker = 4;
+
+/**
+ * The bytes every binary scene starts with
+ */
+static constexpr std::array<char, 4> binarySceneMagic = {'K', 'S', 'C', 'N'};
+
+/**
+ * The version of the binary scene format, incremented whenever the format changes
+ */
+static constexpr uint32_t binarySceneVersion = 2;
+
+/**
+ * An entry in the node table of a binary scene, locating a node's record relative to the start of the records
+ */
+struct BinaryNodeEntry {
+	uint32_t type;
+	uint32_t padding;
+	uint64_t offset;
+	uint64_t size;
+};
+
+/**
+ * Creates a loader for a scene file, loading starts once the application has finished setting up nodes
+ * @param path The full path of the scene file
+ */
+SceneLoader::SceneLoader(const std::string& path) : path(path), numWorkers(1), cancelled(false), numBatches(0), numHandedOver(0),
+	producing(false), numNodes(0), numConstructed(0), numBegun(0),
+	constructed(false), loaded(false), future(promise.get_future().share()) {
+	// Empty Body
+}
+
+/**
+ * Stops loading, waiting for the background thread to finish
+ */
+SceneLoader::~SceneLoader() {
+	cancel();
+}
+
+/**
+ * Starts the background thread, called on the main thread once node setup has finished so every node constructor is known
+ */
+void SceneLoader::start() {
+	std::lock_guard lock(mutex);
+	if (cancelled.load(std::memory_order_relaxed) || thread.joinable()) return;
+	numWorkers = mainApp->getNumUpdateThreads();
+	thread = std::thread(&SceneLoader::load, this);
+}
+
+/**
+ * Stops the background thread, waiting for it to finish
+ */
+void SceneLoader::cancel() {
+	std::thread loadingThread;
+	{
+		std::lock_guard lock(mutex);
+		cancelled.store(true, std::memory_order_relaxed);
+		loadingThread = std::move(thread);
+	}
+	{
+		std::lock_guard lock(batchMutex);
+		batchAvailable.notify_all();
+		batchFinished.notify_all();
+	}
+	if (loadingThread.joinable()) loadingThread.join();
+}
+
+/**
+ * Parses the file and constructs the nodes, run on the background thread
+ */
+void SceneLoader::load() {
+	{
+		std::lock_guard lock(batchMutex);
+		producing = true;
+	}
+	std::vector<std::thread> workers;
+	for (size_t i = 0; i < numWorkers; i++) workers.emplace_back(&SceneLoader::runWorker, this);
+
+	// The file stays mapped until the workers have finished, as binary batches read from the mapping
+	std::optional<MappedFile> file;
+	try {
+		file.emplace(path);
+		bool binary = file->size() >= binarySceneMagic.size() &&
+			std::equal(binarySceneMagic.begin(), binarySceneMagic.end(), reinterpret_cast<const char*>(file->data()));
+		if (binary) loadBinary(*file);
+		else loadJSON(*file);
+	}
+	catch (...) {
+		std::lock_guard lock(batchMutex);
+		if (batchException == nullptr) batchException = std::current_exception();
+	}
+
+	// Let the workers finish the remaining batches
+	{
+		std::lock_guard lock(batchMutex);
+		producing = false;
+	}
+	batchAvailable.notify_all();
+	for (std::thread& worker : workers) worker.join();
+
+	std::exception_ptr exception;
+	{
+		std::lock_guard lock(batchMutex);
+		exception = batchException;
+	}
+	if (exception != nullptr) {
+		try {
+			std::rethrow_exception(exception);
+		}
+		catch (const std::exception& e) {
+			using namespace std::string_literals;
+			console.warn("Scene Loading Failed - "s + e.what());
+		}
+		catch (...) {
+			console.warn("Scene Loading Failed");
+		}
+		loaded.store(true, std::memory_order_release);
+		promise.set_exception(exception);
+	}
+
+	constructed.store(true, std::memory_order_release);
+}
+
+/**
+ * Submits a batch of nodes to the worker threads, waiting while too many batches are in flight
+ * @param construct Constructs the batch's nodes in order
+ * @returns False if loading has been cancelled or has failed and no more batches should be submitted
+ */
+bool SceneLoader::submitBatch(std::function<void(std::vector<std::shared_ptr<Node>>&)> construct) {
+	std::unique_lock lock(batchMutex);
+	batchFinished.wait(lock, [&]() {
+		return numBatches - numHandedOver < batchesInFlightPerWorker * numWorkers || cancelled.load(std::memory_order_relaxed) ||
+			batchException != nullptr;
+	});
+	if (cancelled.load(std::memory_order_relaxed) || batchException != nullptr) return false;
+
+	pendingBatches.push_back({numBatches++, std::move(construct)});
+	lock.unlock();
+	batchAvailable.notify_one();
+	return true;
+}
+
+/**
+ * Constructs batches until no more will be submitted, run on each worker thread
+ */
+void SceneLoader::runWorker() {
+	std::unique_lock lock(batchMutex);
+	while (true) {
+		batchAvailable.wait(lock, [&]() { return !pendingBatches.empty() || !producing; });
+		if (pendingBatches.empty()) return;
+		Batch batch = std::move(pendingBatches.front());
+		pendingBatches.pop_front();
+		bool skip = cancelled.load(std::memory_order_relaxed) || batchException != nullptr;
+		lock.unlock();
+
+		// Batches left after cancelling or failing are skipped, but still handed over so the order stays intact
+		std::vector<std::shared_ptr<Node>> nodes;
+		std::exception_ptr exception;
+		if (!skip) {
+			try {
+				nodes.reserve(nodeBatchSize);
+				batch.construct(nodes);
+			}
+			catch (...) {
+				exception = std::current_exception();
+				nodes.clear();
+			}
+		}
+
+		lock.lock();
+		if (exception != nullptr && batchException == nullptr) batchException = exception;
+		finishedBatches.emplace(batch.index, std::move(nodes));
+		handOverFinished();
+		batchFinished.notify_all();
+	}
+}
+
+/**
+ * Hands every constructed batch which is next in order to the scene, MUST be called with the batch mutex held
+ */
+void SceneLoader::handOverFinished() {
+	for (auto it = finishedBatches.find(numHandedOver); it != finishedBatches.end(); it = finishedBatches.find(numHandedOver)) {
+		std::vector<std::shared_ptr<Node>>& nodes = it->second;
+		size_t count = nodes.size();
+		{
+			std::lock_guard lock(mutex);
+			constructedNodes.insert(constructedNodes.end(), std::make_move_iterator(nodes.begin()), std::make_move_iterator(nodes.end()));
+		}
+		numConstructed.fetch_add(count, std::memory_order_release);
+		finishedBatches.erase(it);
+		numHandedOver++;
+	}
+}
+
+/**
+ * Constructs a node from its JSON save state
+ * @param json The node's JSON
+ * @returns The node
+ * @throws If there is no save state constructor for the node's type
+ */
+std::shared_ptr<Node> SceneLoader::constructNode(JSON&& json) {
+	const std::string type = json.at("node").get<std::string>();
+	auto constructor = Scene::nodeMap.find(type);
+	if (constructor == Scene::nodeMap.end()) throw std::runtime_error("No node save state constructor for " + type);
+	return constructor->second(std::move(json));
+}
+
+/**
+ * Estimates the number of nodes in a JSON scene from the number of node type keys, as the nodes are not counted until they have
+ * all been parsed
+ * @param begin The first byte of the scene
+ * @param end One past the last byte of the scene
+ * @returns The estimated number of nodes
+ */
+static size_t estimateNumNodes(const uint8_t* begin, const uint8_t* end) {
+	static constexpr std::string_view nodeKey = "\"node\"";
+	const char* first = reinterpret_cast<const char*>(begin);
+	const char* last = reinterpret_cast<const char*>(end);
+	const std::boyer_moore_horspool_searcher searcher(nodeKey.begin(), nodeKey.end());
+
+	size_t count = 0;
+	for (const char* it = std::search(first, last, searcher); it != last; it = std::search(it + nodeKey.size(), last, searcher)) count++;
+	return count;
+}
+
+/**
+ * Streams a JSON scene file, submitting the nodes in batches as soon as they have been parsed so only the JSON of the batches in
+ * flight is held at once
+ * @param file The mapped file
+ */
+void SceneLoader::loadJSON(const MappedFile& file) {
+	numNodes.store(estimateNumNodes(file.data(), file.data() + file.size()), std::memory_order_relaxed);
+
+	size_t count = 0;
+	std::vector<JSON> batch;
+	const auto submit = [&]() -> bool {
+		if (batch.empty()) return true;
+		return submitBatch([json = std::move(batch)](std::vector<std::shared_ptr<Node>>& nodes) mutable {
+			for (JSON& nodeJson : json) nodes.push_back(constructNode(std::move(nodeJson)));
+		});
+	};
+
+	SceneParser parser([&](const std::string& key, JSON&& json) {
+		std::lock_guard lock(mutex);
+		if (key == "bgColor") bgColor = json.get<Color>();
+		else if (key == "camera") camera = json.get<Camera>();
+	}, [&](JSON&& json) -> bool {
+		batch.push_back(std::move(json));
+
+		// Keep the progress total at least the number of nodes found so far
+		count++;
+		if (count > numNodes.load(std::memory_order_relaxed)) numNodes.store(count, std::memory_order_relaxed);
+
+		if (batch.size() < nodeBatchSize) return true;
+		bool submitted = submit();
+		batch = std::vector<JSON>();
+		batch.reserve(nodeBatchSize);
+		return submitted;
+	});
+	parser.parse(file.data(), file.data() + file.size());
+	if (submit()) numNodes.store(count, std::memory_order_relaxed);
+}
+
+/**
+ * Reads a binary scene file, submitting its nodes in batches
+ * @param file The mapped file
+ */
+void SceneLoader::loadBinary(const MappedFile& file) {
+	BinarySceneReader reader(file.data(), file.size());
+	reader.read<std::array<char, 4>>();
+	if (reader.read<uint32_t>() != binarySceneVersion) throw std::runtime_error(path + " is an unsupported binary scene version");
+	{
+		std::lock_guard lock(mutex);
+		bgColor = reader.read<Color>();
+		camera.emplace();
+		readBinary(reader, *camera);
+	}
+
+	// Look up the constructor of each type of node once
+	uint32_t numTypes = reader.read<uint32_t>();
+	std::vector<const std::function<std::shared_ptr<Node>(BinarySceneReader&)>*> constructors;
+	constructors.reserve(numTypes);
+	for (uint32_t i = 0; i < numTypes; i++) {
+		std::string type(reader.readString());
+		auto saveState = Scene::binaryNodeMap.find(type);
+		if (saveState == Scene::binaryNodeMap.end()) throw std::runtime_error("No node binary save state for " + type);
+		constructors.push_back(&saveState->second.first);
+	}
+
+	// Every record is read in place from the mapping, which outlives the workers. The constructors are copied into each batch as
+	// the batches outlive this function.
+	std::span<const BinaryNodeEntry> entries = reader.readArray<BinaryNodeEntry>();
+	reader.align(16);
+	numNodes.store(entries.size(), std::memory_order_relaxed);
+	for (size_t begin = 0; begin < entries.size(); begin += nodeBatchSize) {
+		std::span<const BinaryNodeEntry> batch = entries.subspan(begin, std::min(nodeBatchSize, entries.size() - begin));
+		bool submitted = submitBatch([constructors, reader, batch](std::vector<std::shared_ptr<Node>>& nodes) {
+			for (const BinaryNodeEntry& entry : batch) {
+				if (entry.type >= constructors.size()) throw std::runtime_error("Binary scene is corrupt");
+				BinarySceneReader record = reader.section(entry.offset, entry.size);
+				nodes.push_back((*constructors[entry.type])(record));
+			}
+		});
+		if (!submitted) return;
+	}
+}
+
+/**
+ * Moves the constructed nodes and loaded scene properties into the scene, MUST be called on the main thread while no updates
+ * are running
+ * @param nodes The scene's queue of loaded nodes to begin
+ * @param sceneBgColor The scene's background color
+ * @param sceneCamera The scene's camera
+ */
+void SceneLoader::takeNodes(std::deque<std::shared_ptr<Node>>& nodes, Color& sceneBgColor, Camera& sceneCamera) {
+	if (loaded.load(std::memory_order_acquire)) return;
+	{
+		std::lock_guard lock(mutex);
+		if (bgColor.has_value()) sceneBgColor = *bgColor;
+		if (camera.has_value()) sceneCamera = *camera;
+		bgColor.reset();
+		camera.reset();
+		nodes.insert(nodes.end(), std::make_move_iterator(constructedNodes.begin()), std::make_move_iterator(constructedNodes.end()));
+		constructedNodes.clear();
+	}
+	checkLoaded();
+}
+
+/**
+ * Counts the nodes the scene has begun, finishing loading once every node has been begun
+ * @param count The number of nodes begun
+ */
+void SceneLoader::nodesBegun(size_t count) {
+	numBegun.fetch_add(count, std::memory_order_relaxed);
+	checkLoaded();
+}
+
+/**
+ * Finishes loading once the background thread has finished and every constructed node has been begun
+ */
+void SceneLoader::checkLoaded() {
+	if (loaded.load(std::memory_order_acquire) || !constructed.load(std::memory_order_acquire)) return;
+	if (numBegun.load(std::memory_order_relaxed) != numConstructed.load(std::memory_order_acquire)) return;
+	loaded.store(true, std::memory_order_release);
+	promise.set_value();
+}
+
+/**
+ * Gets how far through loading the scene is, can be called on any thread
+ * @returns The progress from 0 to 1
+ */
+float SceneLoader::getProgress() const {
+	if (loaded.load(std::memory_order_acquire)) return 1.0f;
+	size_t total = numNodes.load(std::memory_order_relaxed);
+	if (total == 0) return 0.0f;
+
+	// Parsing counts for the first tenth, constructing and beginning the nodes evenly split the rest
+	float constructedFraction = static_cast<float>(numConstructed.load(std::memory_order_relaxed)) / static_cast<float>(total);
+	float begunFraction = static_cast<float>(numBegun.load(std::memory_order_relaxed)) / static_cast<float>(total);
+	return 0.1f + 0.45f * constructedFraction + 0.45f * begunFraction;
+}
+
+/**
+ * Checks whether or not loading has finished, successfully or not. Can be called on any thread.
+ * @returns Whether or not loading has finished
+ */
+bool SceneLoader::isLoaded() const {
+	return loaded.load(std::memory_order_acquire);
+}
+
+/**
+ * Gets a future ready once every node has been begun, holding the exception loading failed with if it did. Must not be waited
+ * on from the main thread, as nodes are begun on the main thread.
+ * @returns The future
+ */
+std::shared_future<void> SceneLoader::getFuture() const {
+	return future;
+}
+
+/**
+ * Converts a JSON scene file to a binary scene file, loaded by scenes the same way as JSON scene files. Every node within the
+ * file must have a binary save state, so this must be called once node setup has finished such as from a main thread task.
+ * @param jsonFilename The path of the JSON scene file
+ * @param binaryFilename The path of the binary scene file to write
+ * @throws If the JSON scene could not be read or the binary scene could not be written
+ */
+void SceneLoader::convert(const std::string& jsonFilename, const std::string& binaryFilename) {
+	MappedFile file(jsonFilename);
+	std::optional<Color> sceneBgColor;
+	std::optional<Camera> sceneCamera;
+
+	// Each node is constructed from its JSON as it is parsed and written out as its own record
+	std::vector<std::string> types;
+	std::vector<BinaryNodeEntry> entries;
+	BinarySceneWriter records;
+	SceneParser parser([&](const std::string& key, JSON&& json) {
+		if (key == "bgColor") sceneBgColor = json.get<Color>();
+		else if (key == "camera") sceneCamera = json.get<Camera>();
+	}, [&](JSON&& json) -> bool {
+		const std::string type = json.at("node").get<std::string>();
+		auto constructor = Scene::nodeMap.find(type);
+		auto saveState = Scene::binaryNodeMap.find(type);
+		if (constructor == Scene::nodeMap.end() || saveState == Scene::binaryNodeMap.end())
+			throw std::runtime_error("No node binary save state for " + type);
+
+		BinarySceneWriter record;
+		saveState->second.second(*constructor->second(std::move(json)), record);
+
+		BinaryNodeEntry entry = {};
+		entry.type = static_cast<uint32_t>(std::find(types.begin(), types.end(), type) - types.begin());
+		if (entry.type == types.size()) types.push_back(type);
+		records.align(16);
+		entry.offset = records.size();
+		entry.size = record.size();
+		records.append(record);
+		entries.push_back(entry);
+		return true;
+	});
+	parser.parse(file.data(), file.data() + file.size());
+	if (!sceneBgColor.has_value() || !sceneCamera.has_value()) throw std::runtime_error(jsonFilename + " is missing its bgColor or camera");
+
+	BinarySceneWriter writer;
+	writer.write(binarySceneMagic);
+	writer.write(binarySceneVersion);
+	writer.write(*sceneBgColor);
+	writeBinary(writer, *sceneCamera);
+	writer.write(static_cast<uint32_t>(types.size()));
+	for (const std::string& type : types) writer.writeString(type);
+	writer.writeArray<BinaryNodeEntry>(entries);
+	writer.append(records);
+
+	std::ofstream binaryFile(binaryFilename, std::ios::binary);
+	binaryFile.write(reinterpret_cast<const char*>(writer.getData().data()), static_cast<std::streamsize>(writer.size()));
+	if (!binaryFile) throw std::runtime_error("Unable to write " + binaryFilename);
+}
@@ -0,0 +1,326 @@
+/*
+   Copyright 2022 Rishi Challa
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+	   http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+
+#pragma once
+
+#include <Kale/Engine/Node/Node.hpp>
+#include <Kale/Math/Transform/Transform.hpp>
+#include <Kale/Math/Vector/Vector.hpp>
+
+#include <thread>
+#include <atomic>
+#include <mutex>
+#include <condition_variable>
+#include <exception>
+#include <future>
+#include <memory>
+#include <optional>
+#include <vector>
+#include <deque>
+#include <map>
+#include <string>
+#include <functional>
+#include <cstddef>
+
+namespace Kale {
+
+	/**
+	 * Forward declaration of the memory mapped file class
+	 */
+	class MappedFile;
+
+	/**
+	 * Loads a scene save file on a background thread. The file is parsed and every node constructed off of the main thread, the
+	 * constructed nodes are handed to the scene and begun on the main thread within the main thread budget, as beginning nodes
+	 * creates their GPU resources. Scenes loading from a file begin their nodes whether or not they are presented, so the next
+	 * scene can be preloaded while the current scene is presented.
+	 *
+	 * Scene files are either JSON or binary scenes converted from JSON by SceneLoader::convert. Binary scenes are memory mapped
+	 * and hold every node as a flat record, so nodes are read without building a JSON document and their bezier arrays are copied
+	 * out in single blocks. JSON scenes are streamed by SceneParser, so rather than the whole document only the node JSONs of the
+	 * batches in flight are in memory at a time, at most batchesInFlightPerWorker * numWorkers * nodeBatchSize node JSONs.
+	 *
+	 * The background thread only parses the file, splitting the nodes into batches constructed in parallel by a pool of worker
+	 * threads. Constructed batches are handed to the scene in file order, so nodes are added in the same order as they are saved.
+	 */
+	class SceneLoader {
+	private:
+
+		/**
+		 * The full path of the scene file to load
+		 */
+		std::string path;
+
+		/**
+		 * The background thread parsing the file and constructing the nodes
+		 */
+		std::thread thread;
+
+		/**
+		 * A batch of nodes waiting to be constructed by a worker thread
+		 */
+		struct Batch {
+
+			/**
+			 * The position of the batch within the file, batches are handed to the scene in this order
+			 */
+			size_t index;
+
+			/**
+			 * Constructs the batch's nodes in order
+			 */
+			std::function<void(std::vector<std::shared_ptr<Node>>&)> construct;
+		};
+
+		/**
+		 * The number of worker threads constructing nodes, the number of update threads so loading scales with the cores given to
+		 * the application
+		 */
+		size_t numWorkers;
+
+		/**
+		 * Set when the scene is destroyed, stopping the background thread as soon as possible
+		 */
+		std::atomic<bool> cancelled;
+
+		/**
+		 * Used for synchronizing access to the constructed nodes & scene properties and the starting & stopping of the thread
+		 */
+		std::mutex mutex;
+
+		/**
+		 * Used for synchronizing access to the batches, locked before the mutex when both are held
+		 */
+		std::mutex batchMutex;
+
+		/**
+		 * Notified when a batch is submitted or no more batches will be
+		 */
+		std::condition_variable batchAvailable;
+
+		/**
+		 * Notified when a batch has been constructed
+		 */
+		std::condition_variable batchFinished;
+
+		/**
+		 * The batches waiting for a worker thread
+		 */
+		std::deque<Batch> pendingBatches;
+
+		/**
+		 * The batches constructed out of order, waiting for the batches before them
+		 */
+		std::map<size_t, std::vector<std::shared_ptr<Node>>> finishedBatches;
+
+		/**
+		 * The number of batches submitted
+		 */
+		size_t numBatches;
+
+		/**
+		 * The number of batches handed to the scene, the index of the next batch to hand over
+		 */
+		size_t numHandedOver;
+
+		/**
+		 * Whether or not the background thread may still submit batches
+		 */
+		bool producing;
+
+		/**
+		 * The first exception thrown while constructing a batch
+		 */
+		std::exception_ptr batchException;
+
+		/**
+		 * The nodes constructed but not yet taken by the scene
+		 */
+		std::vector<std::shared_ptr<Node>> constructedNodes;
+
+		/**
+		 * The background color loaded from the file, not yet taken by the scene
+		 */
+		std::optional<Color> bgColor;
+
+		/**
+		 * The camera loaded from the file, not yet taken by the scene
+		 */
+		std::optional<Camera> camera;
+
+		/**
+		 * The number of nodes within the file, 0 until the file has been parsed
+		 */
+		std::atomic<size_t> numNodes;
+
+		/**
+		 * The number of nodes constructed so far
+		 */
+		std::atomic<size_t> numConstructed;
+
+		/**
+		 * The number of nodes the scene has begun so far
+		 */
+		std::atomic<size_t> numBegun;
+
+		/**
+		 * Whether or not the background thread has finished, successfully or not
+		 */
+		std::atomic<bool> constructed;
+
+		/**
+		 * Whether or not every node has been begun or loading has failed
+		 */
+		std::atomic<bool> loaded;
+
+		/**
+		 * Set once loading finishes, holding the exception loading failed with if it did
+		 */
+		std::promise<void> promise;
+
+		/**
+		 * The future of the promise, shared with anyone waiting for the scene to load
+		 */
+		std::shared_future<void> future;
+
+		/**
+		 * Parses the file and constructs the nodes, run on the background thread
+		 */
+		void load();
+
+		/**
+		 * Streams a JSON scene file, submitting the nodes in batches as soon as they have been parsed so only the JSON of the
+		 * batches in flight is held at once
+		 * @param file The mapped file
+		 */
+		void loadJSON(const MappedFile& file);
+
+		/**
+		 * Reads a binary scene file, submitting its nodes in batches
+		 * @param file The mapped file
+		 */
+		void loadBinary(const MappedFile& file);
+
+		/**
+		 * Submits a batch of nodes to the worker threads, waiting while too many batches are in flight
+		 * @param construct Constructs the batch's nodes in order
+		 * @returns False if loading has been cancelled or has failed and no more batches should be submitted
+		 */
+		bool submitBatch(std::function<void(std::vector<std::shared_ptr<Node>>&)> construct);
+
+		/**
+		 * Constructs batches until no more will be submitted, run on each worker thread
+		 */
+		void runWorker();
+
+		/**
+		 * Hands every constructed batch which is next in order to the scene, MUST be called with the batch mutex held
+		 */
+		void handOverFinished();
+
+		/**
+		 * Constructs a node from its JSON save state
+		 * @param json The node's JSON
+		 * @returns The node
+		 * @throws If there is no save state constructor for the node's type
+		 */
+		static std::shared_ptr<Node> constructNode(JSON&& json);
+
+		/**
+		 * Starts the background thread, called on the main thread once node setup has finished so every node constructor is known
+		 */
+		void start();
+
+		/**
+		 * Stops the background thread, waiting for it to finish
+		 */
+		void cancel();
+
+		/**
+		 * Moves the constructed nodes and loaded scene properties into the scene, MUST be called on the main thread while no updates
+		 * are running
+		 * @param nodes The scene's queue of loaded nodes to begin
+		 * @param sceneBgColor The scene's background color
+		 * @param sceneCamera The scene's camera
+		 */
+		void takeNodes(std::deque<std::shared_ptr<Node>>& nodes, Color& sceneBgColor, Camera& sceneCamera);
+
+		/**
+		 * Counts the nodes the scene has begun, finishing loading once every node has been begun
+		 * @param count The number of nodes begun
+		 */
+		void nodesBegun(size_t count);
+
+		/**
+		 * Finishes loading once the background thread has finished and every constructed node has been begun
+		 */
+		void checkLoaded();
+
+		friend class Scene;
+
+	public:
+
+		/**
+		 * Creates a loader for a scene file, loading starts once the application has finished setting up nodes
+		 * @param path The full path of the scene file
+		 */
+		explicit SceneLoader(const std::string& path);
+
+		/**
+		 * Scene loaders do not support copying
+		 */
+		SceneLoader(const SceneLoader& other) = delete;
+
+		/**
+		 * Scene loaders do not support copying
+		 */
+		void operator=(const SceneLoader& other) = delete;
+
+		/**
+		 * Stops loading, waiting for the background thread to finish
+		 */
+		~SceneLoader();
+
+		/**
+		 * Gets how far through loading the scene is, can be called on any thread
+		 * @returns The progress from 0 to 1
+		 */
+		float getProgress() const;
+
+		/**
+		 * Checks whether or not loading has finished, successfully or not. Can be called on any thread.
+		 * @returns Whether or not loading has finished
+		 */
+		bool isLoaded() const;
+
+		/**
+		 * Gets a future ready once every node has been begun, holding the exception loading failed with if it did. Must not be waited
+		 * on from the main thread, as nodes are begun on the main thread.
+		 * @returns The future
+		 */
+		std::shared_future<void> getFuture() const;
+
+		/**
+		 * Converts a JSON scene file to a binary scene file, loaded by scenes the same way as JSON scene files. Every node within the
+		 * file must have a binary save state, so this must be called once node setup has finished such as from a main thread task.
+		 * @param jsonFilename The path of the JSON scene file
+		 * @param binaryFilename The path of the binary scene file to write
+		 * @throws If the JSON scene could not be read or the binary scene could not be written
+		 */
+		static void convert(const std::string& jsonFilename, const std::string& binaryFilename);
+	};
+}
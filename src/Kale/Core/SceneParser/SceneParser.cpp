@@ -0,0 +1,236 @@
+/*
+   Copyright 2022 Rishi Challa
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+	   http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+
+#include "SceneParser.hpp"
+
+#include <stdexcept>
+#include <utility>
+
+using namespace Kale;
+
+/**
+ * Creates a new scene parser
+ * @param onProperty Called with the key and value of each property of the scene object other than the nodes array
+ * @param onNode Called with each element of the nodes array in order, returning false to stop parsing
+ */
+SceneParser::SceneParser(std::function<void(const std::string&, JSON&&)> onProperty, std::function<bool(JSON&&)> onNode) :
+	onProperty(std::move(onProperty)), onNode(std::move(onNode)), sceneDepth(0), building(false), stopped(false) {
+	// Empty Body
+}
+
+/**
+ * Parses a JSON scene, comments are ignored
+ * @param begin The first byte of the scene
+ * @param end One past the last byte of the scene
+ * @throws If the JSON is malformed
+ */
+void SceneParser::parse(const uint8_t* begin, const uint8_t* end) {
+	sceneDepth = 0;
+	building = false;
+	stopped = false;
+	containers.clear();
+	JSON::sax_parse(begin, end, this, nlohmann::detail::input_format_t::json, true, true);
+}
+
+/**
+ * Adds a parsed value to the value being built, or starts building a value if none is
+ * @param parsed The parsed value
+ * @returns The added value
+ */
+JSON& SceneParser::add(JSON&& parsed) {
+	if (sceneDepth == 0) throw std::runtime_error("Scene files must hold a single object");
+	if (!building) {
+		building = true;
+		value = std::move(parsed);
+		return value;
+	}
+
+	// Containers further out are not modified until the innermost container ends, so the pointers to them stay valid
+	JSON& container = *containers.back();
+	if (container.is_array()) {
+		container.push_back(std::move(parsed));
+		return container.back();
+	}
+	JSON& element = container[valueKey];
+	element = std::move(parsed);
+	return element;
+}
+
+/**
+ * Adds a parsed number, string or literal to the value being built, handing it over if it is a value on its own
+ * @param parsed The parsed value
+ * @returns Whether or not to continue parsing
+ */
+bool SceneParser::addScalar(JSON&& parsed) {
+	add(std::move(parsed));
+	return containers.empty() ? finish() : true;
+}
+
+/**
+ * Hands over the built value once it is complete
+ * @returns False if parsing should stop
+ */
+bool SceneParser::finish() {
+	building = false;
+	JSON built = std::move(value);
+	value = nullptr;
+	if (sceneDepth == 2) {
+		stopped = !onNode(std::move(built));
+		return !stopped;
+	}
+	onProperty(propertyKey, std::move(built));
+	return true;
+}
+
+/**
+ * Called when a null is parsed
+ * @returns Whether or not to continue parsing
+ */
+bool SceneParser::null() {
+	return addScalar(nullptr);
+}
+
+/**
+ * Called when a boolean is parsed
+ * @param val The boolean
+ * @returns Whether or not to continue parsing
+ */
+bool SceneParser::boolean(bool val) {
+	return addScalar(val);
+}
+
+/**
+ * Called when a signed integer is parsed
+ * @param val The integer
+ * @returns Whether or not to continue parsing
+ */
+bool SceneParser::number_integer(number_integer_t val) {
+	return addScalar(val);
+}
+
+/**
+ * Called when an unsigned integer is parsed
+ * @param val The integer
+ * @returns Whether or not to continue parsing
+ */
+bool SceneParser::number_unsigned(number_unsigned_t val) {
+	return addScalar(val);
+}
+
+/**
+ * Called when a floating point number is parsed
+ * @param val The number
+ * @param s The number as written in the file
+ * @returns Whether or not to continue parsing
+ */
+bool SceneParser::number_float(number_float_t val, const string_t& s) {
+	return addScalar(val);
+}
+
+/**
+ * Called when a string is parsed
+ * @param val The string
+ * @returns Whether or not to continue parsing
+ */
+bool SceneParser::string(string_t& val) {
+	return addScalar(std::move(val));
+}
+
+/**
+ * Called when binary data is parsed, which JSON text never holds
+ * @param val The binary data
+ * @returns Whether or not to continue parsing
+ */
+bool SceneParser::binary(binary_t& val) {
+	return addScalar(JSON(std::move(val)));
+}
+
+/**
+ * Called when an object begins
+ * @param elements The number of elements, or -1 if unknown
+ * @returns Whether or not to continue parsing
+ */
+bool SceneParser::start_object(std::size_t elements) {
+	if (!building && sceneDepth == 0) {
+		sceneDepth = 1;
+		return true;
+	}
+	containers.push_back(&add(JSON::object()));
+	return true;
+}
+
+/**
+ * Called when an object key is parsed
+ * @param val The key
+ * @returns Whether or not to continue parsing
+ */
+bool SceneParser::key(string_t& val) {
+	if (building) valueKey = std::move(val);
+	else propertyKey = std::move(val);
+	return true;
+}
+
+/**
+ * Called when an object ends
+ * @returns Whether or not to continue parsing
+ */
+bool SceneParser::end_object() {
+	if (!building) {
+		sceneDepth = 0;
+		return true;
+	}
+	containers.pop_back();
+	return containers.empty() ? finish() : true;
+}
+
+/**
+ * Called when an array begins
+ * @param elements The number of elements, or -1 if unknown
+ * @returns Whether or not to continue parsing
+ */
+bool SceneParser::start_array(std::size_t elements) {
+	if (!building && sceneDepth == 1 && propertyKey == "nodes") {
+		sceneDepth = 2;
+		return true;
+	}
+	containers.push_back(&add(JSON::array()));
+	return true;
+}
+
+/**
+ * Called when an array ends
+ * @returns Whether or not to continue parsing
+ */
+bool SceneParser::end_array() {
+	if (!building) {
+		sceneDepth = 1;
+		return true;
+	}
+	containers.pop_back();
+	return containers.empty() ? finish() : true;
+}
+
+/**
+ * Called when the JSON is malformed
+ * @param position The byte the error occurred at
+ * @param lastToken The last token read
+ * @param ex The parse error
+ * @returns Never returns, the error is thrown
+ */
+bool SceneParser::parse_error(std::size_t position, const std::string& lastToken, const nlohmann::detail::exception& ex) {
+	throw std::runtime_error(ex.what());
+}
@@ -0,0 +1,215 @@
+/*
+   Copyright 2022 Rishi Challa
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+	   http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+
+#pragma once
+
+#include <nlohmann/json.hpp>
+
+#include <functional>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace Kale {
+
+	/**
+	 * Shorthand for nlohmann::json
+	 */
+	using JSON = nlohmann::json;
+
+	/**
+	 * Streams a JSON scene file without building a document of the whole file. Each property of the scene object is built on its
+	 * own, except for the nodes array whose elements are built and handed over one at a time, so only a single node's JSON is held
+	 * in memory at once no matter how large the scene is.
+	 */
+	class SceneParser : public nlohmann::json_sax<JSON> {
+	private:
+
+		/**
+		 * Called with each property of the scene object other than the nodes array
+		 */
+		std::function<void(const std::string&, JSON&&)> onProperty;
+
+		/**
+		 * Called with each element of the nodes array, returning false to stop parsing
+		 */
+		std::function<bool(JSON&&)> onNode;
+
+		/**
+		 * How deep the parser is within the scene's structure, 1 within the scene object and 2 within the nodes array
+		 */
+		int sceneDepth;
+
+		/**
+		 * The key of the scene property currently being parsed
+		 */
+		std::string propertyKey;
+
+		/**
+		 * The value currently being built, either a scene property or a node
+		 */
+		JSON value;
+
+		/**
+		 * The objects and arrays being built within the value, innermost last
+		 */
+		std::vector<JSON*> containers;
+
+		/**
+		 * The key within the innermost object being built the next value is set to
+		 */
+		std::string valueKey;
+
+		/**
+		 * Whether or not a value is being built
+		 */
+		bool building;
+
+		/**
+		 * Whether or not parsing was stopped by the node callback
+		 */
+		bool stopped;
+
+		/**
+		 * Adds a parsed value to the value being built, or starts building a value if none is
+		 * @param parsed The parsed value
+		 * @returns The added value
+		 */
+		JSON& add(JSON&& parsed);
+
+		/**
+		 * Adds a parsed number, string or literal to the value being built, handing it over if it is a value on its own
+		 * @param parsed The parsed value
+		 * @returns Whether or not to continue parsing
+		 */
+		bool addScalar(JSON&& parsed);
+
+		/**
+		 * Hands over the built value once it is complete
+		 * @returns False if parsing should stop
+		 */
+		bool finish();
+
+	public:
+
+		/**
+		 * Creates a new scene parser
+		 * @param onProperty Called with the key and value of each property of the scene object other than the nodes array
+		 * @param onNode Called with each element of the nodes array in order, returning false to stop parsing
+		 */
+		SceneParser(std::function<void(const std::string&, JSON&&)> onProperty, std::function<bool(JSON&&)> onNode);
+
+		/**
+		 * Parses a JSON scene, comments are ignored
+		 * @param begin The first byte of the scene
+		 * @param end One past the last byte of the scene
+		 * @throws If the JSON is malformed
+		 */
+		void parse(const uint8_t* begin, const uint8_t* end);
+
+		/**
+		 * Called when a null is parsed
+		 * @returns Whether or not to continue parsing
+		 */
+		bool null() override;
+
+		/**
+		 * Called when a boolean is parsed
+		 * @param val The boolean
+		 * @returns Whether or not to continue parsing
+		 */
+		bool boolean(bool val) override;
+
+		/**
+		 * Called when a signed integer is parsed
+		 * @param val The integer
+		 * @returns Whether or not to continue parsing
+		 */
+		bool number_integer(number_integer_t val) override;
+
+		/**
+		 * Called when an unsigned integer is parsed
+		 * @param val The integer
+		 * @returns Whether or not to continue parsing
+		 */
+		bool number_unsigned(number_unsigned_t val) override;
+
+		/**
+		 * Called when a floating point number is parsed
+		 * @param val The number
+		 * @param s The number as written in the file
+		 * @returns Whether or not to continue parsing
+		 */
+		bool number_float(number_float_t val, const string_t& s) override;
+
+		/**
+		 * Called when a string is parsed
+		 * @param val The string
+		 * @returns Whether or not to continue parsing
+		 */
+		bool string(string_t& val) override;
+
+		/**
+		 * Called when binary data is parsed, which JSON text never holds
+		 * @param val The binary data
+		 * @returns Whether or not to continue parsing
+		 */
+		bool binary(binary_t& val) override;
+
+		/**
+		 * Called when an object begins
+		 * @param elements The number of elements, or -1 if unknown
+		 * @returns Whether or not to continue parsing
+		 */
+		bool start_object(std::size_t elements) override;
+
+		/**
+		 * Called when an object key is parsed
+		 * @param val The key
+		 * @returns Whether or not to continue parsing
+		 */
+		bool key(string_t& val) override;
+
+		/**
+		 * Called when an object ends
+		 * @returns Whether or not to continue parsing
+		 */
+		bool end_object() override;
+
+		/**
+		 * Called when an array begins
+		 * @param elements The number of elements, or -1 if unknown
+		 * @returns Whether or not to continue parsing
+		 */
+		bool start_array(std::size_t elements) override;
+
+		/**
+		 * Called when an array ends
+		 * @returns Whether or not to continue parsing
+		 */
+		bool end_array() override;
+
+		/**
+		 * Called when the JSON is malformed
+		 * @param position The byte the error occurred at
+		 * @param lastToken The last token read
+		 * @param ex The parse error
+		 * @returns Never returns, the error is thrown
+		 */
+		bool parse_error(std::size_t position, const std::string& lastToken, const nlohmann::detail::exception& ex) override;
+	};
+}
@@ -0,0 +1,233 @@
+/*
+   Copyright 2022 Rishi Challa
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+	   http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+#pragma once
+
+#include <vector>
+#include <utility>
+#include <cstdint>
+#include <cstddef>
+#include <limits>
+
+namespace Kale {
+
+	/**
+	 * A stable handle to a value within a slot map. Handles stay valid while the value is held and become invalid once it is erased,
+	 * even if the slot is later reused.
+	 */
+	struct SlotHandle {
+
+		/**
+		 * The index of the slot
+		 */
+		uint32_t index = std::numeric_limits<uint32_t>::max();
+
+		/**
+		 * The generation of the slot when the handle was created
+		 */
+		uint32_t generation = 0;
+
+		/**
+		 * Checks whether or not two handles refer to the same slot and generation
+		 * @param other The other handle
+		 * @returns Whether or not the handles are equal
+		 */
+		bool operator==(const SlotHandle& other) const {
+			return index == other.index && generation == other.generation;
+		}
+	};
+
+	/**
+	 * A generational slot map. Values are stored contiguously for fast iteration and referenced by stable handles,
+	 * insertion and erasure are both constant time. Erasure moves the last value into the erased value's place.
+	 * @tparam T The type of value to hold
+	 */
+	template <typename T> class SlotMap {
+	private:
+
+		/**
+		 * A single slot, indirecting a handle to the value's position
+		 */
+		struct Slot {
+
+			/**
+			 * The position of the value if the slot is occupied, or the next free slot if not
+			 */
+			uint32_t position;
+
+			/**
+			 * The generation of the slot, incremented every time the slot is freed
+			 */
+			uint32_t generation;
+		};
+
+		/**
+		 * The values held, contiguous in memory
+		 */
+		std::vector<T> values;
+
+		/**
+		 * The slot index of each value, parallel to values
+		 */
+		std::vector<uint32_t> valueSlots;
+
+		/**
+		 * The slots indirecting handles to values
+		 */
+		std::vector<Slot> slots;
+
+		/**
+		 * The index of the first free slot
+		 */
+		uint32_t freeHead = std::numeric_limits<uint32_t>::max();
+
+	public:
+
+		/**
+		 * Reserves space for the given number of values
+		 * @param capacity The number of values to reserve space for
+		 */
+		void reserve(size_t capacity) {
+			values.reserve(capacity);
+			valueSlots.reserve(capacity);
+			slots.reserve(capacity);
+		}
+
+		/**
+		 * Inserts a value into the map
+		 * @param value The value to insert
+		 * @returns The handle to the value
+		 */
+		SlotHandle insert(T value) {
+			uint32_t slotIndex;
+			if (freeHead != std::numeric_limits<uint32_t>::max()) {
+				slotIndex = freeHead;
+				freeHead = slots[slotIndex].position;
+			}
+			else {
+				slotIndex = static_cast<uint32_t>(slots.size());
+				slots.push_back(Slot{0, 0});
+			}
+
+			slots[slotIndex].position = static_cast<uint32_t>(values.size());
+			values.push_back(std::move(value));
+			valueSlots.push_back(slotIndex);
+			return SlotHandle{slotIndex, slots[slotIndex].generation};
+		}
+
+		/**
+		 * Checks whether or not a handle refers to a value held in the map
+		 * @param handle The handle to check
+		 * @returns Whether or not the handle is valid
+		 */
+		bool contains(SlotHandle handle) const {
+			return handle.index < slots.size() && slots[handle.index].generation == handle.generation;
+		}
+
+		/**
+		 * Gets the value referred to by a handle
+		 * @param handle The handle of the value
+		 * @returns A pointer to the value, or nullptr if the handle is no longer valid
+		 */
+		T* get(SlotHandle handle) {
+			if (!contains(handle)) return nullptr;
+			return &values[slots[handle.index].position];
+		}
+
+		/**
+		 * Gets the value referred to by a handle
+		 * @param handle The handle of the value
+		 * @returns A pointer to the value, or nullptr if the handle is no longer valid
+		 */
+		const T* get(SlotHandle handle) const {
+			if (!contains(handle)) return nullptr;
+			return &values[slots[handle.index].position];
+		}
+
+		/**
+		 * Erases the value referred to by a handle
+		 * @param handle The handle of the value
+		 * @returns False if the handle was no longer valid and nothing was erased
+		 */
+		bool erase(SlotHandle handle) {
+			if (!contains(handle)) return false;
+
+			// Move the last value into the erased value's position
+			uint32_t position = slots[handle.index].position;
+			if (position != values.size() - 1) {
+				values[position] = std::move(values.back());
+				valueSlots[position] = valueSlots.back();
+				slots[valueSlots[position]].position = position;
+			}
+			values.pop_back();
+			valueSlots.pop_back();
+
+			// Invalidate existing handles & free the slot
+			slots[handle.index].generation++;
+			slots[handle.index].position = freeHead;
+			freeHead = handle.index;
+			return true;
+		}
+
+		/**
+		 * Gets the values held, contiguous but in no guaranteed order
+		 * @returns The values
+		 */
+		const std::vector<T>& getValues() const {
+			return values;
+		}
+
+		/**
+		 * Gets the number of values held
+		 * @returns The number of values
+		 */
+		size_t size() const {
+			return values.size();
+		}
+
+		/**
+		 * Gets an iterator to the first value
+		 * @returns The iterator
+		 */
+		typename std::vector<T>::iterator begin() {
+			return values.begin();
+		}
+
+		/**
+		 * Gets an iterator past the last value
+		 * @returns The iterator
+		 */
+		typename std::vector<T>::iterator end() {
+			return values.end();
+		}
+
+		/**
+		 * Gets an iterator to the first value
+		 * @returns The iterator
+		 */
+		typename std::vector<T>::const_iterator begin() const {
+			return values.begin();
+		}
+
+		/**
+		 * Gets an iterator past the last value
+		 * @returns The iterator
+		 */
+		typename std::vector<T>::const_iterator end() const {
+			return values.end();
+		}
+	};
+}
@@ -0,0 +1,65 @@
+/*
+   Copyright 2022 Rishi Challa
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+	   http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+#include "Task.hpp"
+
+using namespace Kale;
+
+/**
+ * Moves a task
+ * @param other The task to move from, left empty
+ */
+Task::Task(Task&& other) noexcept : operations(other.operations) {
+	if (operations == nullptr) return;
+	operations->move(other.storage, storage);
+	other.operations = nullptr;
+}
+
+/**
+ * Moves a task
+ * @param other The task to move from, left empty
+ * @returns This task
+ */
+Task& Task::operator=(Task&& other) noexcept {
+	if (this == &other) return *this;
+	if (operations != nullptr) operations->destroy(storage);
+	operations = other.operations;
+	if (operations != nullptr) operations->move(other.storage, storage);
+	other.operations = nullptr;
+	return *this;
+}
+
+/**
+ * Destroys the held callable
+ */
+Task::~Task() {
+	if (operations != nullptr) operations->destroy(storage);
+}
+
+/**
+ * Runs the task
+ */
+void Task::operator()() {
+	operations->invoke(storage);
+}
+
+/**
+ * Checks whether or not the task holds a callable
+ * @returns Whether or not the task holds a callable
+ */
+Task::operator bool() const noexcept {
+	return operations != nullptr;
+}
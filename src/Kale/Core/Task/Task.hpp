@@ -0,0 +1,158 @@
+/*
+   Copyright 2022 Rishi Challa
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+	   http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+#pragma once
+
+#include <new>
+#include <utility>
+#include <type_traits>
+#include <cstddef>
+
+namespace Kale {
+
+	/**
+	 * A move only callable taking no arguments, used for tasks passed between threads. Small callables (such as lambdas capturing
+	 * a few pointers) are stored inline rather than allocated on the heap like std::function.
+	 */
+	class Task {
+	private:
+
+		/**
+		 * The size of the inline storage, callables larger than this are allocated on the heap
+		 */
+		static constexpr size_t inlineSize = 48;
+
+		/**
+		 * The type erased operations on a stored callable
+		 */
+		struct Operations {
+
+			/**
+			 * Calls the callable held in storage
+			 */
+			void (*invoke)(void* storage);
+
+			/**
+			 * Moves the callable from one storage to another, destroying the source
+			 */
+			void (*move)(void* from, void* to);
+
+			/**
+			 * Destroys the callable held in storage
+			 */
+			void (*destroy)(void* storage);
+		};
+
+		/**
+		 * The operations for callables held inline
+		 * @tparam F The type of the callable
+		 */
+		template <typename F> struct InlineCallable {
+			static void invoke(void* storage) { (*std::launder(reinterpret_cast<F*>(storage)))(); }
+			static void move(void* from, void* to) {
+				F* source = std::launder(reinterpret_cast<F*>(from));
+				new (to) F(std::move(*source));
+				source->~F();
+			}
+			static void destroy(void* storage) { std::launder(reinterpret_cast<F*>(storage))->~F(); }
+			static constexpr Operations operations = {invoke, move, destroy};
+		};
+
+		/**
+		 * The operations for callables held on the heap, the storage holds a pointer to the callable
+		 * @tparam F The type of the callable
+		 */
+		template <typename F> struct HeapCallable {
+			static void invoke(void* storage) { (**reinterpret_cast<F**>(storage))(); }
+			static void move(void* from, void* to) { *reinterpret_cast<F**>(to) = *reinterpret_cast<F**>(from); }
+			static void destroy(void* storage) { delete *reinterpret_cast<F**>(storage); }
+			static constexpr Operations operations = {invoke, move, destroy};
+		};
+
+		/**
+		 * The storage for the callable, or a pointer to it if held on the heap
+		 */
+		alignas(std::max_align_t) unsigned char storage[inlineSize];
+
+		/**
+		 * The operations for the held callable, nullptr if empty
+		 */
+		const Operations* operations = nullptr;
+
+	public:
+
+		/**
+		 * Creates an empty task
+		 */
+		Task() = default;
+
+		/**
+		 * Creates a task from a callable
+		 * @param func The callable to call when the task is run
+		 */
+		template <typename F, typename = std::enable_if_t<!std::is_same_v<std::decay_t<F>, Task>>> Task(F&& func) {
+			using Callable = std::decay_t<F>;
+			if constexpr (sizeof(Callable) <= inlineSize && alignof(Callable) <= alignof(std::max_align_t) &&
+				std::is_nothrow_move_constructible_v<Callable>) {
+				new (storage) Callable(std::forward<F>(func));
+				operations = &InlineCallable<Callable>::operations;
+			}
+			else {
+				*reinterpret_cast<Callable**>(storage) = new Callable(std::forward<F>(func));
+				operations = &HeapCallable<Callable>::operations;
+			}
+		}
+
+		/**
+		 * Moves a task
+		 * @param other The task to move from, left empty
+		 */
+		Task(Task&& other) noexcept;
+
+		/**
+		 * Moves a task
+		 * @param other The task to move from, left empty
+		 * @returns This task
+		 */
+		Task& operator=(Task&& other) noexcept;
+
+		/**
+		 * Tasks do not support copying
+		 */
+		Task(const Task& other) = delete;
+
+		/**
+		 * Tasks do not support copying
+		 */
+		void operator=(const Task& other) = delete;
+
+		/**
+		 * Destroys the held callable
+		 */
+		~Task();
+
+		/**
+		 * Runs the task
+		 */
+		void operator()();
+
+		/**
+		 * Checks whether or not the task holds a callable
+		 * @returns Whether or not the task holds a callable
+		 */
+		explicit operator bool() const noexcept;
+	};
+}
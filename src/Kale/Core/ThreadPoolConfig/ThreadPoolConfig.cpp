@@ -0,0 +1,214 @@
+/*
+   Copyright 2022 Rishi Challa
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+	   http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+#include "ThreadPoolConfig.hpp"
+
+#include <algorithm>
+#include <set>
+#include <utility>
+
+#if defined(KALE_WINDOWS)
+#include <windows.h>
+#else
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+#if defined(KALE_OSX) || defined(KALE_IOS)
+#include <sys/sysctl.h>
+#elif !defined(KALE_WINDOWS)
+#include <fstream>
+#include <string>
+#endif
+
+using namespace Kale;
+
+#if !defined(KALE_WINDOWS) && !defined(KALE_OSX) && !defined(KALE_IOS)
+/**
+ * Gets the cores this process may run on, queried once on first use. The affinity is per thread, so it is cached before the
+ * render thread is pinned to its own cores, keeping the answer the same whichever thread asks.
+ * @returns The cores this process may run on, nullopt if the affinity couldn't be queried
+ */
+static const std::optional<cpu_set_t>& getProcessAffinity() {
+	static const std::optional<cpu_set_t> affinity = []() -> std::optional<cpu_set_t> {
+		cpu_set_t set;
+		CPU_ZERO(&set);
+		if (sched_getaffinity(0, sizeof(set), &set) != 0 || CPU_COUNT(&set) == 0) return std::nullopt;
+		return set;
+	}();
+	return affinity;
+}
+#endif
+
+/**
+ * Gets the number of update threads this configuration results in
+ * @returns The number of update threads, at least one
+ */
+size_t ThreadPoolConfig::getWorkerCount() const {
+	size_t hardwareThreads = getHardwareThreadCount();
+	size_t count = hardwareThreads;
+
+	switch (workerCountPolicy) {
+		case WorkerCountPolicy::HardwareThreads:
+			count = hardwareThreads;
+			break;
+		case WorkerCountPolicy::HardwareThreadsMinusOne:
+			count = hardwareThreads - 1;
+			break;
+		case WorkerCountPolicy::PhysicalCores:
+			count = getPhysicalCoreCount();
+			break;
+		case WorkerCountPolicy::PhysicalCoresMinusOne:
+			count = getPhysicalCoreCount() - 1;
+			break;
+		case WorkerCountPolicy::Fixed:
+			count = workerCount;
+			break;
+	}
+
+	if (maxWorkerCount != 0) count = std::min(count, maxWorkerCount);
+	return std::max<size_t>(count, 1);
+}
+
+/**
+ * Gets the number of logical cores this process may run on, respecting the process affinity where the platform supports it.
+ * The affinity is queried once on first use, so the answer doesn't change once the render thread is pinned.
+ * @returns The number of logical cores, at least one
+ */
+size_t ThreadPoolConfig::getHardwareThreadCount() {
+#if !defined(KALE_WINDOWS) && !defined(KALE_OSX) && !defined(KALE_IOS)
+	// Containers & taskset restrict the cores through the affinity while hardware_concurrency reports every core on the machine
+	if (const std::optional<cpu_set_t>& affinity = getProcessAffinity()) return static_cast<size_t>(CPU_COUNT(&*affinity));
+#endif
+	return std::max<size_t>(std::thread::hardware_concurrency(), 1);
+}
+
+/**
+ * Gets the number of physical cores on this device
+ * @returns The number of physical cores, or the number of hardware threads if it can't be determined
+ */
+size_t ThreadPoolConfig::getPhysicalCoreCount() {
+	static const size_t physicalCores = []() -> size_t {
+		size_t fallback = getHardwareThreadCount();
+
+#if defined(KALE_WINDOWS)
+		// Count the processor core entries
+		DWORD length = 0;
+		GetLogicalProcessorInformation(nullptr, &length);
+		std::vector<SYSTEM_LOGICAL_PROCESSOR_INFORMATION> info(length / sizeof(SYSTEM_LOGICAL_PROCESSOR_INFORMATION));
+		if (info.empty() || !GetLogicalProcessorInformation(info.data(), &length)) return fallback;
+		size_t cores = static_cast<size_t>(std::count_if(info.begin(), info.end(), [](const SYSTEM_LOGICAL_PROCESSOR_INFORMATION& entry) -> bool {
+			return entry.Relationship == RelationProcessorCore;
+		}));
+		return cores == 0 ? fallback : cores;
+#elif defined(KALE_OSX) || defined(KALE_IOS)
+		int cores = 0;
+		size_t size = sizeof(cores);
+		if (sysctlbyname("hw.physicalcpu", &cores, &size, nullptr, 0) != 0 || cores <= 0) return fallback;
+		return static_cast<size_t>(cores);
+#else
+		// Count the unique package & core id pairs of every logical core this process may run on
+		const std::optional<cpu_set_t>& available = getProcessAffinity();
+		if (!available.has_value()) return fallback;
+		std::set<std::pair<int, int>> cores;
+		for (size_t cpu = 0; cpu < CPU_SETSIZE; cpu++) {
+			if (!CPU_ISSET(cpu, &*available)) continue;
+			const std::string path = "/sys/devices/system/cpu/cpu" + std::to_string(cpu) + "/topology/";
+			std::ifstream packageFile(path + "physical_package_id");
+			std::ifstream coreFile(path + "core_id");
+			int package = 0, core = 0;
+			if (!(packageFile >> package) || !(coreFile >> core)) return fallback;
+			cores.emplace(package, core);
+		}
+		return cores.empty() ? fallback : cores.size();
+#endif
+	}();
+
+	return physicalCores;
+}
+
+/**
+ * Restricts a thread to run on the given logical cores
+ * @param thread The thread to restrict
+ * @param cores The logical cores the thread may run on
+ * @returns False if the affinity could not be set on this platform
+ */
+bool ThreadPoolConfig::setAffinity(std::thread& thread, const std::vector<size_t>& cores) {
+	if (cores.empty()) return true;
+
+#if defined(KALE_WINDOWS)
+	DWORD_PTR mask = 0;
+	for (size_t core : cores) if (core < sizeof(DWORD_PTR) * 8) mask |= static_cast<DWORD_PTR>(1) << core;
+	return mask != 0 && SetThreadAffinityMask(static_cast<HANDLE>(thread.native_handle()), mask) != 0;
+#elif defined(KALE_OSX) || defined(KALE_IOS)
+	// Apple platforms do not support pinning threads to cores
+	return false;
+#else
+	cpu_set_t set;
+	CPU_ZERO(&set);
+	for (size_t core : cores) if (core < CPU_SETSIZE) CPU_SET(core, &set);
+	return pthread_setaffinity_np(thread.native_handle(), sizeof(set), &set) == 0;
+#endif
+}
+
+/**
+ * Restricts the calling thread to run on the given logical cores
+ * @param cores The logical cores the thread may run on
+ * @returns False if the affinity could not be set on this platform
+ */
+bool ThreadPoolConfig::setCurrentThreadAffinity(const std::vector<size_t>& cores) {
+	if (cores.empty()) return true;
+
+#if defined(KALE_WINDOWS)
+	DWORD_PTR mask = 0;
+	for (size_t core : cores) if (core < sizeof(DWORD_PTR) * 8) mask |= static_cast<DWORD_PTR>(1) << core;
+	return mask != 0 && SetThreadAffinityMask(GetCurrentThread(), mask) != 0;
+#elif defined(KALE_OSX) || defined(KALE_IOS)
+	// Apple platforms do not support pinning threads to cores
+	return false;
+#else
+	cpu_set_t set;
+	CPU_ZERO(&set);
+	for (size_t core : cores) if (core < CPU_SETSIZE) CPU_SET(core, &set);
+	return pthread_setaffinity_np(pthread_self(), sizeof(set), &set) == 0;
+#endif
+}
+
+/**
+ * Gives the calling thread a scheduling priority
+ * @param priority The priority to give the thread, from 0 (lowest) to maxThreadPriority (highest)
+ * @returns False if the priority could not be set, usually due to a lack of privileges
+ */
+bool ThreadPoolConfig::setCurrentThreadPriority(int priority) {
+	priority = std::clamp(priority, 0, maxThreadPriority);
+
+#if defined(KALE_WINDOWS)
+	// Map the level onto the Windows priority levels
+	constexpr int levels[] = {
+		THREAD_PRIORITY_LOWEST, THREAD_PRIORITY_BELOW_NORMAL, THREAD_PRIORITY_NORMAL,
+		THREAD_PRIORITY_ABOVE_NORMAL, THREAD_PRIORITY_HIGHEST, THREAD_PRIORITY_TIME_CRITICAL
+	};
+	constexpr int numLevels = static_cast<int>(sizeof(levels) / sizeof(levels[0]));
+	return SetThreadPriority(GetCurrentThread(), levels[priority * (numLevels - 1) / maxThreadPriority]) != 0;
+#else
+	// Map the level onto the SCHED_FIFO range
+	const int min = sched_get_priority_min(SCHED_FIFO);
+	const int max = sched_get_priority_max(SCHED_FIFO);
+	sched_param param{};
+	param.sched_priority = min + (max - min) * priority / maxThreadPriority;
+	return pthread_setschedparam(pthread_self(), SCHED_FIFO, &param) == 0;
+#endif
+}
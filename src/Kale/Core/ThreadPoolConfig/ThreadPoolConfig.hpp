@@ -0,0 +1,142 @@
+/*
+   Copyright 2022 Rishi Challa
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+	   http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+#pragma once
+
+#include <thread>
+#include <vector>
+#include <optional>
+#include <cstddef>
+
+namespace Kale {
+
+	/**
+	 * Policies for choosing the number of update threads
+	 */
+	enum class WorkerCountPolicy {
+		
+		/**
+		 * One update thread per hardware thread
+		 */
+		HardwareThreads = 0,
+		
+		/**
+		 * One update thread per hardware thread, leaving one for the render thread
+		 */
+		HardwareThreadsMinusOne = 1,
+		
+		/**
+		 * One update thread per physical core, avoiding hyperthreading siblings competing for the same core
+		 */
+		PhysicalCores = 2,
+		
+		/**
+		 * One update thread per physical core, leaving one for the render thread
+		 */
+		PhysicalCoresMinusOne = 3,
+
+		/**
+		 * Exactly ThreadPoolConfig::workerCount update threads
+		 */
+		Fixed = 4
+	};
+
+	/**
+	 * Configures the update threads created by the application & the render thread
+	 */
+	struct ThreadPoolConfig {
+
+		/**
+		 * The policy used to pick the number of update threads
+		 */
+		WorkerCountPolicy workerCountPolicy = WorkerCountPolicy::HardwareThreads;
+
+		/**
+		 * The number of update threads when using WorkerCountPolicy::Fixed
+		 */
+		size_t workerCount = 1;
+
+		/**
+		 * The maximum number of update threads regardless of policy, 0 for no limit. Useful in shared containers where the hardware
+		 * reports far more cores than the process is given.
+		 */
+		size_t maxWorkerCount = 0;
+
+		/**
+		 * The logical cores each update thread may run on, update thread i uses workerAffinity[i % size]. Leave empty to let the OS
+		 * schedule the update threads freely.
+		 */
+		std::vector<std::vector<size_t>> workerAffinity;
+
+		/**
+		 * The logical cores the render (main) thread may run on, leave empty to let the OS schedule it freely
+		 */
+		std::vector<size_t> renderThreadAffinity;
+
+		/**
+		 * The priority to give the render (main) thread, from 0 (lowest) to 100 (highest). This is mapped onto the platform's
+		 * range, the SCHED_FIFO real time range on POSIX which usually requires elevated privileges & the thread priority levels
+		 * on Windows. Leave empty to keep the default priority.
+		 */
+		std::optional<int> renderThreadPriority;
+
+		/**
+		 * Gets the number of update threads this configuration results in
+		 * @returns The number of update threads, at least one
+		 */
+		size_t getWorkerCount() const;
+
+		/**
+		 * The highest priority level accepted by setCurrentThreadPriority
+		 */
+		static constexpr int maxThreadPriority = 100;
+
+		/**
+		 * Gets the number of logical cores this process may run on, respecting the process affinity where the platform supports it.
+		 * The affinity is queried once on first use, so the answer doesn't change once the render thread is pinned.
+		 * @returns The number of logical cores, at least one
+		 */
+		static size_t getHardwareThreadCount();
+
+		/**
+		 * Gets the number of physical cores on this device
+		 * @returns The number of physical cores, or the number of hardware threads if it can't be determined
+		 */
+		static size_t getPhysicalCoreCount();
+
+		/**
+		 * Restricts a thread to run on the given logical cores
+		 * @param thread The thread to restrict
+		 * @param cores The logical cores the thread may run on
+		 * @returns False if the affinity could not be set on this platform
+		 */
+		static bool setAffinity(std::thread& thread, const std::vector<size_t>& cores);
+
+		/**
+		 * Restricts the calling thread to run on the given logical cores
+		 * @param cores The logical cores the thread may run on
+		 * @returns False if the affinity could not be set on this platform
+		 */
+		static bool setCurrentThreadAffinity(const std::vector<size_t>& cores);
+
+		/**
+		 * Gives the calling thread a scheduling priority
+		 * @param priority The priority to give the thread, from 0 (lowest) to maxThreadPriority (highest)
+		 * @returns False if the priority could not be set, usually due to a lack of privileges
+		 */
+		static bool setCurrentThreadPriority(int priority);
+	};
+}
@@ -0,0 +1,149 @@
+/*
+   Copyright 2022 Rishi Challa
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+	   http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+
+#pragma once
+
+#include <array>
+#include <vector>
+#include <utility>
+#include <cstdint>
+#include <cstddef>
+
+namespace Kale {
+
+	/**
+	 * A hierarchical timer wheel. Items are scheduled to expire at a tick and are only touched again when their slot comes due,
+	 * so scheduling is constant time and advancing costs one slot per tick plus the items which expire. Items due far in the future
+	 * are held in coarser levels and cascade down as their time approaches.
+	 * @tparam T The type of item held
+	 */
+	template <typename T> class TimerWheel {
+	private:
+
+		/**
+		 * The number of bits of the time covered by each level
+		 */
+		static constexpr size_t slotBits = 6;
+
+		/**
+		 * The number of slots in each level
+		 */
+		static constexpr size_t numSlots = size_t(1) << slotBits;
+
+		/**
+		 * The number of levels, the wheel covers 2^(slotBits * numLevels) ticks ahead before clamping to its last level
+		 */
+		static constexpr size_t numLevels = 4;
+
+		/**
+		 * The slots of every level, each holding its items along with the tick they are due
+		 */
+		std::array<std::array<std::vector<std::pair<uint64_t, T>>, numSlots>, numLevels> levels;
+
+		/**
+		 * The current tick of the wheel
+		 */
+		uint64_t time;
+
+		/**
+		 * The number of items held
+		 */
+		size_t numItems;
+
+		/**
+		 * Places an item in the finest level covering its due tick
+		 * @param due The tick the item is due, must be after the current tick
+		 * @param item The item to place
+		 */
+		void place(uint64_t due, T&& item) {
+			uint64_t delay = due - time;
+			size_t level = 0;
+			while (level + 1 < numLevels && delay >= (uint64_t(1) << (slotBits * (level + 1)))) level++;
+
+			// Items beyond the last level are parked in the furthest slot and placed again once it cascades
+			uint64_t slotTime = due;
+			if (delay >= (uint64_t(1) << (slotBits * numLevels))) slotTime = time + (uint64_t(1) << (slotBits * numLevels)) - 1;
+			levels[level][(slotTime >> (slotBits * level)) & (numSlots - 1)].emplace_back(due, std::move(item));
+		}
+
+	public:
+
+		/**
+		 * Creates an empty timer wheel at tick 0
+		 */
+		TimerWheel() : time(0), numItems(0) {
+			// Empty Body
+		}
+
+		/**
+		 * Schedules an item to expire at a tick
+		 * @param due The tick the item expires at, items due at or before the current tick expire on the next tick
+		 * @param item The item to schedule
+		 */
+		void schedule(uint64_t due, T item) {
+			if (due <= time) due = time + 1;
+			place(due, std::move(item));
+			numItems++;
+		}
+
+		/**
+		 * Advances the wheel tick by tick up to a tick, expiring every item due on the way in order of their due ticks
+		 * @param target The tick to advance to, nothing happens if this isn't after the current tick
+		 * @param expire Called with every item which expires
+		 */
+		template <typename F> void advance(uint64_t target, F&& expire) {
+			std::vector<std::pair<uint64_t, T>> due;
+			while (time < target) {
+				time++;
+
+				// Cascade the coarser slots which have come due from the top down, so items fall through to the finest level covering them
+				for (size_t level = numLevels - 1; level > 0; level--) {
+					if ((time & ((uint64_t(1) << (slotBits * level)) - 1)) != 0) continue;
+					std::vector<std::pair<uint64_t, T>>& slot = levels[level][(time >> (slotBits * level)) & (numSlots - 1)];
+					due.swap(slot);
+					for (std::pair<uint64_t, T>& entry : due) {
+						if (entry.first <= time) levels[0][time & (numSlots - 1)].push_back(std::move(entry));
+						else place(entry.first, std::move(entry.second));
+					}
+					due.clear();
+				}
+
+				// Expire the items of this tick, items may be scheduled again from expire
+				due.swap(levels[0][time & (numSlots - 1)]);
+				numItems -= due.size();
+				for (std::pair<uint64_t, T>& entry : due) expire(std::move(entry.second));
+				due.clear();
+			}
+		}
+
+		/**
+		 * Gets the current tick of the wheel
+		 * @returns The current tick
+		 */
+		uint64_t getTime() const {
+			return time;
+		}
+
+		/**
+		 * Gets the number of items scheduled
+		 * @returns The number of items
+		 */
+		size_t size() const {
+			return numItems;
+		}
+	};
+}
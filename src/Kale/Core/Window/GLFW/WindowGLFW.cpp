@@ -68,6 +68,9 @@ Window::Window() {
 	glfwWindowHint(GLFW_OPENGL_FORWARD_COMPAT, GL_TRUE);
 	glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
 
+	// Curve filled path nodes are drawn through the stencil buffer
+	glfwWindowHint(GLFW_STENCIL_BITS, 8);
+
 #ifdef KALE_DEBUG
 	glfwWindowHint(GLFW_OPENGL_DEBUG_CONTEXT, GL_TRUE);
 #endif
@@ -315,6 +318,9 @@ void Window::update() {
 	
 	// Poll Events
 	glfwPollEvents();
+
+	// Live input is not dispatched while replaying recorded input
+	if (handlers == nullptr) return;
 	
 	// Gamepad input
 	for (_WinGamePad& gamepad : gamePads) {
@@ -466,6 +472,14 @@ void Window::update() {
 	}
 }
 
+/**
+ * Sets whether or not live input is dispatched to the event handlers, disabled while replaying recorded input
+ * @param enabled Whether or not live input is dispatched
+ */
+void Window::setLiveEvents(bool enabled) {
+	handlers = enabled ? &eventHandlers : nullptr;
+}
+
 /**
  * Gets the extensions required for VKCreateInfo depending on the windowing API
  * @returns The required extensions for the lower level windowing API
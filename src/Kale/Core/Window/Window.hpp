@@ -103,6 +103,12 @@ namespace Kale {
 		 */
 		void update();
 
+		/**
+		 * Sets whether or not live input is dispatched to the event handlers, disabled while replaying recorded input
+		 * @param enabled Whether or not live input is dispatched
+		 */
+		void setLiveEvents(bool enabled);
+
 		/**
 		 * Gets the extensions required for VKCreateInfo depending on the windowing API
 		 * @returns The required extensions for the lower level windowing API
@@ -0,0 +1,162 @@
+/*
+   Copyright 2022 Rishi Challa
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+	   http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+#pragma once
+
+#include <atomic>
+#include <memory>
+#include <optional>
+#include <type_traits>
+#include <cstdint>
+#include <cstddef>
+
+namespace Kale {
+
+	/**
+	 * A bounded Chase-Lev work stealing deque. The owning thread pushes and pops from the bottom of the deque while any other
+	 * thread may steal from the top of the deque without locking.
+	 * @tparam T The type of item held, must be trivially copyable and lock free when atomic (indices or pointers)
+	 */
+	template <typename T> class WorkStealingDeque {
+	private:
+
+		static_assert(std::is_trivially_copyable<T>::value, "Work stealing deques can only hold trivially copyable items");
+
+		/**
+		 * The ring buffer holding the items, accessed atomically as thieves may read while the owner writes
+		 */
+		std::unique_ptr<std::atomic<T>[]> buffer;
+
+		/**
+		 * The capacity of the ring buffer, always a power of two
+		 */
+		size_t capacity;
+
+		/**
+		 * The index of the top of the deque, incremented by thieves
+		 */
+		alignas(64) std::atomic<int64_t> top;
+
+		/**
+		 * The index of the bottom of the deque, only modified by the owning thread
+		 */
+		alignas(64) std::atomic<int64_t> bottom;
+
+	public:
+
+		/**
+		 * Creates a new work stealing deque
+		 * @param capacity The minimum capacity of the deque, rounded up to a power of two
+		 */
+		explicit WorkStealingDeque(size_t capacity = 64) : capacity(0), top(0), bottom(0) {
+			reserve(capacity);
+		}
+
+		/**
+		 * Work stealing deques do not support copying
+		 */
+		WorkStealingDeque(const WorkStealingDeque& other) = delete;
+
+		/**
+		 * Work stealing deques do not support copying
+		 */
+		void operator=(const WorkStealingDeque& other) = delete;
+
+		/**
+		 * Clears the deque and grows the buffer to fit at least the given number of items. This must not be called while any other
+		 * thread may be accessing the deque.
+		 * @param minCapacity The minimum number of items the deque must be able to hold
+		 */
+		void reserve(size_t minCapacity) {
+			top.store(0, std::memory_order_relaxed);
+			bottom.store(0, std::memory_order_relaxed);
+			if (minCapacity <= capacity) return;
+
+			size_t newCapacity = 1;
+			while (newCapacity < minCapacity) newCapacity <<= 1;
+			buffer = std::make_unique<std::atomic<T>[]>(newCapacity);
+			capacity = newCapacity;
+		}
+
+		/**
+		 * Pushes an item to the bottom of the deque, may only be called from the owning thread
+		 * @param item The item to push
+		 * @returns False if the deque is full and the item was not pushed
+		 */
+		bool push(T item) {
+			int64_t b = bottom.load(std::memory_order_relaxed);
+			int64_t t = top.load(std::memory_order_acquire);
+			if (b - t >= static_cast<int64_t>(capacity)) return false;
+
+			buffer[static_cast<size_t>(b) & (capacity - 1)].store(item, std::memory_order_relaxed);
+			std::atomic_thread_fence(std::memory_order_release);
+			bottom.store(b + 1, std::memory_order_relaxed);
+			return true;
+		}
+
+		/**
+		 * Pops an item from the bottom of the deque, may only be called from the owning thread
+		 * @returns The item, or nullopt if the deque is empty
+		 */
+		std::optional<T> pop() {
+			int64_t b = bottom.load(std::memory_order_relaxed) - 1;
+			bottom.store(b, std::memory_order_relaxed);
+			std::atomic_thread_fence(std::memory_order_seq_cst);
+			int64_t t = top.load(std::memory_order_relaxed);
+
+			// The deque was already empty
+			if (t > b) {
+				bottom.store(b + 1, std::memory_order_relaxed);
+				return std::nullopt;
+			}
+
+			T item = buffer[static_cast<size_t>(b) & (capacity - 1)].load(std::memory_order_relaxed);
+			if (t != b) return item;
+
+			// This is the last item, race against thieves for it
+			bool won = top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed);
+			bottom.store(b + 1, std::memory_order_relaxed);
+			if (!won) return std::nullopt;
+			return item;
+		}
+
+		/**
+		 * Steals an item from the top of the deque, may be called from any thread
+		 * @returns The item, or nullopt if the deque is empty or another thread won the race for the item
+		 */
+		std::optional<T> steal() {
+			int64_t t = top.load(std::memory_order_acquire);
+			std::atomic_thread_fence(std::memory_order_seq_cst);
+			int64_t b = bottom.load(std::memory_order_acquire);
+			if (t >= b) return std::nullopt;
+
+			T item = buffer[static_cast<size_t>(t) & (capacity - 1)].load(std::memory_order_relaxed);
+			if (!top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+				return std::nullopt;
+			return item;
+		}
+
+		/**
+		 * Checks whether or not the deque currently appears empty, may be called from any thread
+		 * @returns Whether or not the deque is empty
+		 */
+		bool empty() const {
+			int64_t t = top.load(std::memory_order_acquire);
+			int64_t b = bottom.load(std::memory_order_acquire);
+			return t >= b;
+		}
+	};
+}
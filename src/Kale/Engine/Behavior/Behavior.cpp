@@ -0,0 +1,97 @@
+/*
+   Copyright 2022 Rishi Challa
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+	   http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+
+#include "Behavior.hpp"
+
+#include <algorithm>
+
+using namespace Kale;
+
+/**
+ * Creates a behavior owning a coroutine
+ * @param handle The handle of the coroutine
+ */
+Behavior::Behavior(std::coroutine_handle<promise_type> handle) : handle(handle) {
+	// Empty Body
+}
+
+/**
+ * Takes ownership of another behavior's coroutine
+ * @param other The behavior to move from
+ */
+Behavior::Behavior(Behavior&& other) noexcept : handle(std::exchange(other.handle, nullptr)) {
+	// Empty Body
+}
+
+/**
+ * Takes ownership of another behavior's coroutine, destroying the currently owned coroutine
+ * @param other The behavior to move from
+ * @returns This behavior
+ */
+Behavior& Behavior::operator=(Behavior&& other) noexcept {
+	if (this == &other) return *this;
+	if (handle) handle.destroy();
+	handle = std::exchange(other.handle, nullptr);
+	return *this;
+}
+
+/**
+ * Destroys the owned coroutine
+ */
+Behavior::~Behavior() {
+	if (handle) handle.destroy();
+}
+
+/**
+ * Checks whether or not the behavior has finished
+ * @returns Whether or not the behavior has finished
+ */
+bool Behavior::done() const {
+	return !handle || handle.done();
+}
+
+/**
+ * Advances the time the behavior has waited for and resumes it if what it is waiting on is ready. Rethrows any exception
+ * thrown out of the behavior.
+ * @param deltaTime The time in microseconds since the behavior was last given the chance to resume
+ * @returns Whether or not the behavior was resumed
+ */
+bool Behavior::resume(float deltaTime) {
+	if (done()) return false;
+
+	// The behavior itself may be moved while running (e.g. by starting another behavior), so only the frame is used from here on
+	std::coroutine_handle<promise_type> coroutine = handle;
+	promise_type& promise = coroutine.promise();
+	promise.waitTime -= deltaTime;
+	if (promise.waitTime > 0.0f) return false;
+	if (promise.condition != nullptr && !promise.condition(promise.conditionArgument)) return false;
+
+	promise.waitTime = 0.0f;
+	promise.condition = nullptr;
+	coroutine.resume();
+	if (promise.exception) std::rethrow_exception(std::exchange(promise.exception, nullptr));
+	return true;
+}
+
+/**
+ * Gets the time left before the behavior may resume
+ * @returns The time in microseconds, 0 if the behavior may resume next frame or waits on a condition
+ */
+float Behavior::getWaitTime() const {
+	if (done() || handle.promise().condition != nullptr) return 0.0f;
+	return std::max(handle.promise().waitTime, 0.0f);
+}
@@ -0,0 +1,258 @@
+/*
+   Copyright 2022 Rishi Challa
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+	   http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+
+#pragma once
+
+#include <Kale/Core/FramePool/FramePool.hpp>
+
+#include <coroutine>
+#include <exception>
+#include <utility>
+#include <cstddef>
+
+namespace Kale {
+
+	/**
+	 * A coroutine run by a node across frames, allowing sequenced behavior to be written from top to bottom rather than as a state
+	 * machine. Behaviors are started with Node::startBehavior and resumed on the thread updating their node right after its update,
+	 * so they may access the node without locking. Behaviors suspend with co_await nextFrame(), co_await seconds(duration) or
+	 * co_await animationFinished(fsm). Coroutine frames are allocated from the FramePool.
+	 */
+	class Behavior {
+	public:
+
+		/**
+		 * The promise of a behavior coroutine, holding what the behavior is waiting on
+		 */
+		struct promise_type {
+
+			/**
+			 * The time in microseconds left before the behavior may resume
+			 */
+			float waitTime = 0.0f;
+
+			/**
+			 * The condition which must hold before the behavior may resume, nullptr if there is none
+			 */
+			bool (*condition)(const void*) = nullptr;
+
+			/**
+			 * The argument passed to the condition
+			 */
+			const void* conditionArgument = nullptr;
+
+			/**
+			 * The exception thrown out of the behavior, rethrown from Behavior::resume
+			 */
+			std::exception_ptr exception;
+
+			/**
+			 * Creates the behavior owning this coroutine
+			 * @returns The behavior
+			 */
+			Behavior get_return_object() {
+				return Behavior(std::coroutine_handle<promise_type>::from_promise(*this));
+			}
+
+			/**
+			 * Behaviors start suspended, they first run when their node resumes them
+			 * @returns The awaiter suspending the behavior
+			 */
+			std::suspend_always initial_suspend() noexcept {
+				return {};
+			}
+
+			/**
+			 * Behaviors stay suspended once finished so their node can see they are done
+			 * @returns The awaiter suspending the behavior
+			 */
+			std::suspend_always final_suspend() noexcept {
+				return {};
+			}
+
+			/**
+			 * Called when the behavior finishes
+			 */
+			void return_void() {
+				// Empty Body
+			}
+
+			/**
+			 * Stores an exception thrown out of the behavior
+			 */
+			void unhandled_exception() {
+				exception = std::current_exception();
+			}
+
+			/**
+			 * Allocates the coroutine frame from the frame pool
+			 * @param size The size of the frame
+			 * @returns The frame
+			 */
+			static void* operator new(size_t size) {
+				return FramePool::allocate(size);
+			}
+
+			/**
+			 * Frees the coroutine frame to the frame pool
+			 * @param frame The frame
+			 * @param size The size of the frame
+			 */
+			static void operator delete(void* frame, size_t size) noexcept {
+				FramePool::deallocate(frame, size);
+			}
+		};
+
+	private:
+
+		/**
+		 * The handle of the owned coroutine
+		 */
+		std::coroutine_handle<promise_type> handle;
+
+		/**
+		 * Creates a behavior owning a coroutine
+		 * @param handle The handle of the coroutine
+		 */
+		explicit Behavior(std::coroutine_handle<promise_type> handle);
+
+	public:
+
+		/**
+		 * Behaviors do not support copying
+		 */
+		Behavior(const Behavior& other) = delete;
+
+		/**
+		 * Behaviors do not support copying
+		 */
+		Behavior& operator=(const Behavior& other) = delete;
+
+		/**
+		 * Takes ownership of another behavior's coroutine
+		 * @param other The behavior to move from
+		 */
+		Behavior(Behavior&& other) noexcept;
+
+		/**
+		 * Takes ownership of another behavior's coroutine, destroying the currently owned coroutine
+		 * @param other The behavior to move from
+		 * @returns This behavior
+		 */
+		Behavior& operator=(Behavior&& other) noexcept;
+
+		/**
+		 * Destroys the owned coroutine
+		 */
+		~Behavior();
+
+		/**
+		 * Checks whether or not the behavior has finished
+		 * @returns Whether or not the behavior has finished
+		 */
+		bool done() const;
+
+		/**
+		 * Advances the time the behavior has waited for and resumes it if what it is waiting on is ready. Rethrows any exception
+		 * thrown out of the behavior.
+		 * @param deltaTime The time in microseconds since the behavior was last given the chance to resume
+		 * @returns Whether or not the behavior was resumed
+		 */
+		bool resume(float deltaTime);
+
+		/**
+		 * Gets the time left before the behavior may resume
+		 * @returns The time in microseconds, 0 if the behavior may resume next frame or waits on a condition
+		 */
+		float getWaitTime() const;
+	};
+
+	/**
+	 * The awaiter suspending a behavior until a time has passed and a condition holds
+	 */
+	struct BehaviorWait {
+
+		/**
+		 * The time in microseconds to wait for
+		 */
+		float time;
+
+		/**
+		 * The condition to wait for, nullptr if there is none
+		 */
+		bool (*condition)(const void*);
+
+		/**
+		 * The argument passed to the condition
+		 */
+		const void* conditionArgument;
+
+		/**
+		 * Behaviors always suspend for at least a frame
+		 * @returns false
+		 */
+		bool await_ready() const noexcept {
+			return false;
+		}
+
+		/**
+		 * Stores what the behavior waits on within its promise
+		 * @param handle The suspended behavior
+		 */
+		void await_suspend(std::coroutine_handle<Behavior::promise_type> handle) const noexcept {
+			handle.promise().waitTime = time;
+			handle.promise().condition = condition;
+			handle.promise().conditionArgument = conditionArgument;
+		}
+
+		/**
+		 * Called when the behavior resumes
+		 */
+		void await_resume() const noexcept {
+			// Empty Body
+		}
+	};
+
+	/**
+	 * Suspends a behavior until its node's next update
+	 * @returns The awaiter
+	 */
+	inline BehaviorWait nextFrame() {
+		return BehaviorWait{0.0f, nullptr, nullptr};
+	}
+
+	/**
+	 * Suspends a behavior for a duration, the node may sleep until the behavior is due
+	 * @param duration The duration in seconds
+	 * @returns The awaiter
+	 */
+	inline BehaviorWait seconds(float duration) {
+		return BehaviorWait{duration * 1000000.0f, nullptr, nullptr};
+	}
+
+	/**
+	 * Suspends a behavior until a state animatable is no longer transitioning between states, checked every update of the node
+	 * @tparam T The type of state animatable
+	 * @param animatable The state animatable to wait on, must outlive the wait
+	 * @returns The awaiter
+	 */
+	template <typename T> BehaviorWait animationFinished(const T& animatable) {
+		return BehaviorWait{0.0f, [](const void* argument) -> bool {
+			return !static_cast<const T*>(argument)->isTransitioning();
+		}, &animatable};
+	}
+}
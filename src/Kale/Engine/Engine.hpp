@@ -18,8 +18,11 @@
 
 #include <Kale/Core/Scene/Scene.hpp>
 
+#include "Behavior/Behavior.hpp"
 #include "Collidable/Collidable.hpp"
 #include "Node/Node.hpp"
+#include "PathBatch/PathBatch.hpp"
+#include "PathMesh/PathMesh.hpp"
 #include "PathNode/PathNode.hpp"
 #include "SkeletalAnimatable/SkeletalAnimatable.hpp"
 #include "StateAnimatable/StateAnimatable.hpp"
@@ -16,13 +16,24 @@
 
 #include "Node.hpp"
 
+#include <Kale/Core/Scene/Scene.hpp>
+#include <Kale/Core/Logger/Logger.hpp>
+
+#include <algorithm>
+#include <limits>
+#include <exception>
+#include <string>
+
 using namespace Kale;
 
 /**
  * Creates the node parent
  */
-Node::Node() {
-	// Empty Body
+Node::Node() : numDependencies(0), numAwakeDependencies(0), pendingPreUpdateDependencies(0), pendingUpdateDependencies(0),
+	owningScene(nullptr), sleeping(false), wakeRequested(false), updateInterval(0.0f), nextUpdateDelay(-1.0f), sleepDelay(0.0f),
+	lodDeferred(false), lastUpdateTime(0.0), timerGeneration(0) {
+	averageUpdateTime = updateTime;
+	averagePreUpdateTime = preUpdateTime;
 }
 
 /**
@@ -30,8 +41,11 @@ Node::Node() {
  * @param preUpdateTime The average pre update time, please see Node::preUpdateTime for documentation
  * @param updateTime The average update time, please see Node::updateTime for documentation
  */
-Node::Node(float preUpdateTime, float updateTime) : preUpdateTime(preUpdateTime), updateTime(updateTime) {
-   // Empty Body
+Node::Node(float preUpdateTime, float updateTime) : numDependencies(0), numAwakeDependencies(0), pendingPreUpdateDependencies(0),
+	pendingUpdateDependencies(0), owningScene(nullptr), sleeping(false), wakeRequested(false), updateInterval(0.0f),
+	nextUpdateDelay(-1.0f), sleepDelay(0.0f), lodDeferred(false), lastUpdateTime(0.0), timerGeneration(0), preUpdateTime(preUpdateTime), updateTime(updateTime) {
+	averageUpdateTime = updateTime;
+	averagePreUpdateTime = preUpdateTime;
 }
 
 /**
@@ -77,3 +91,156 @@ void Node::preUpdate(size_t threadNum, const Scene& scene, float deltaTime) {
 void Node::end(const Scene& scene) {
 	// Empty Body
 }
+
+/**
+ * Gets the nodes which must finish pre updating before this node pre updates, and finish updating before this node updates.
+ * The scene reads the dependencies whenever its nodes change, dependencies not within the scene are ignored.
+ * @returns The nodes this node depends on
+ */
+std::vector<Node*> Node::getUpdateDependencies() const {
+	return {};
+}
+
+/**
+ * Checks whether or not the node has nothing left to simulate, called after each update. Dormant nodes are put to sleep
+ * and skip pre updates and updates until woken by Node::wake.
+ * @returns Whether or not the node is dormant, false by default so nodes are always updated
+ */
+bool Node::isDormant() const {
+	return false;
+}
+
+/**
+ * Starts running a behavior on this node. The behavior first runs right after this node's next update, or after the
+ * current update when started from within update. Must only be called from the thread currently updating this node, or
+ * from the main thread while no updates are running.
+ * @param behavior The behavior to run
+ */
+void Node::startBehavior(Behavior behavior) {
+	behaviors.push_back(std::move(behavior));
+	wake();
+}
+
+/**
+ * Gives every running behavior the chance to resume, called after each update. Finished behaviors are removed and
+ * exceptions thrown out of behaviors are logged.
+ * @param deltaTime The time in microseconds since the last update
+ * @returns The time in microseconds until a behavior may next resume, 0 if one must be resumed next update and infinity
+ * if no behaviors remain
+ */
+float Node::runBehaviors(float deltaTime) {
+	if (behaviors.empty()) return std::numeric_limits<float>::infinity();
+
+	// Behaviors may start other behaviors while running, these are first run after the next update
+	size_t numBehaviors = behaviors.size();
+	for (size_t i = 0; i < numBehaviors; i++) {
+		try {
+			behaviors[i].resume(deltaTime);
+		}
+		catch (const std::exception& e) {
+			console.error("Behavior failed on node " + name + " - " + e.what());
+		}
+		catch (...) {
+			console.error("Behavior failed on node " + name);
+		}
+	}
+	std::erase_if(behaviors, [](const Behavior& behavior) { return behavior.done(); });
+
+	float waitTime = std::numeric_limits<float>::infinity();
+	for (const Behavior& behavior : behaviors) waitTime = std::min(waitTime, behavior.getWaitTime());
+	return waitTime;
+}
+
+/**
+ * Copies any state used by render into a snapshot, guaranteed to be called from the main thread while no updates are running.
+ * Nodes which override render must only read state captured here, as in pipelined rendering render runs while the
+ * next frame updates.
+ */
+void Node::takeRenderSnapshot() {
+	// Empty Body
+}
+
+/**
+ * Blends the previous and current render snapshots for fixed timestep rendering, guaranteed to be called from the main
+ * thread prior to rendering. Only called when the application runs with a fixed update rate.
+ * @param alpha How far between the previous (0) and current (1) snapshot the rendered frame lies
+ */
+void Node::interpolateRenderSnapshot(float alpha) {
+	// Empty Body
+}
+
+/**
+ * Gets the measured average time this node takes to update. Until the node has been updated this is updateTime.
+ * Should only be read outside of updates (e.g. from the main thread) to avoid data races.
+ * @returns The average update time in microseconds
+ */
+float Node::getAverageUpdateTime() const {
+	return averageUpdateTime;
+}
+
+/**
+ * Gets the measured average time this node takes to pre update. Until the node has been pre updated this is preUpdateTime.
+ * Should only be read outside of updates (e.g. from the main thread) to avoid data races.
+ * @returns The average pre update time in microseconds
+ */
+float Node::getAveragePreUpdateTime() const {
+	return averagePreUpdateTime;
+}
+
+/**
+ * Wakes the node if it is asleep, so it is pre updated and updated again from the next frame along with every node depending
+ * on it. Must be called after any property write the node's pre update or update must respond to. Can be called from the main
+ * thread or from any update thread during updates.
+ */
+void Node::wake() {
+	// Only the first wake since the node was last checked needs to reach the scene
+	if (wakeRequested.exchange(true, std::memory_order_relaxed)) return;
+	if (sleeping && owningScene != nullptr) owningScene->queueWake(sceneHandle);
+}
+
+/**
+ * Sets the interval between updates of this node. The node sleeps between updates and each pre update & update is passed the
+ * full time since the node's last update. Takes effect after the node's next update.
+ * @param interval The interval in microseconds, 0 to update every frame
+ */
+void Node::setUpdateInterval(float interval) {
+	updateInterval = std::max(interval, 0.0f);
+}
+
+/**
+ * Sets the rate this node is updated at, please see Node::setUpdateInterval for documentation
+ * @param rate The number of updates per second, 0 to update every frame
+ */
+void Node::setUpdateRate(float rate) {
+	setUpdateInterval(rate > 0.0f ? 1000000.0f / rate : 0.0f);
+}
+
+/**
+ * Gets the interval between updates of this node
+ * @returns The interval in microseconds, 0 if the node updates every frame
+ */
+float Node::getUpdateInterval() const {
+	return updateInterval;
+}
+
+/**
+ * Defers the node's following update, once the current update finishes the node sleeps for the given delay regardless of its
+ * update interval. Should be called from the node's own pre update or update.
+ * @param delay The delay in microseconds
+ */
+void Node::scheduleNextUpdate(float delay) {
+	nextUpdateDelay = std::max(delay, 0.0f);
+	lodDeferred = false;
+}
+
+/**
+ * Defers the node's following update for update level of detail, please see Node::scheduleNextUpdate for documentation. The
+ * node is woken early when the bounding box moves into a nearer level of detail tier, such as when it is scrolled into view.
+ * @param delay The delay in microseconds, usually from Scene::getUpdateLODInterval
+ * @param boundingBox The world space bounding box of the node the delay was found for
+ */
+void Node::scheduleNextUpdate(float delay, const Rect& boundingBox) {
+	nextUpdateDelay = std::max(delay, 0.0f);
+	lodDeferred = true;
+	lodBounds = boundingBox;
+}
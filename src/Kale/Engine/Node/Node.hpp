@@ -17,9 +17,15 @@
 #pragma once
 
 #include <Kale/Math/Transform/Transform.hpp>
+#include <Kale/Core/SlotMap/SlotMap.hpp>
+#include <Kale/Engine/Behavior/Behavior.hpp>
 
 #include <mutex>
 #include <optional>
+#include <utility>
+#include <vector>
+#include <atomic>
+#include <cstdint>
 
 namespace Kale {
 
@@ -34,6 +40,123 @@ namespace Kale {
 	class Node {
 	private:
 
+		/**
+		 * The measured average time (in microseconds) this node takes to update, an exponential moving average maintained by the
+		 * scene which starts at updateTime.
+		 */
+		float averageUpdateTime;
+
+		/**
+		 * The measured average time (in microseconds) this node takes to pre update, an exponential moving average maintained by
+		 * the scene which starts at preUpdateTime.
+		 */
+		float averagePreUpdateTime;
+
+		/**
+		 * The handle of this node within its scene's node registry
+		 */
+		SlotHandle sceneHandle;
+
+		/**
+		 * The thread and index of this node within its scene's per thread update lists
+		 */
+		std::pair<size_t, size_t> updateLocation;
+
+		/**
+		 * The thread and index of this node within its scene's per thread pre update lists
+		 */
+		std::pair<size_t, size_t> preUpdateLocation;
+
+		/**
+		 * The nodes within the scene which depend on this node, released once this node finishes each phase
+		 */
+		std::vector<Node*> dependents;
+
+		/**
+		 * The number of nodes within the scene this node depends on
+		 */
+		uint32_t numDependencies;
+
+		/**
+		 * The number of awake nodes within the scene this node depends on, the dependencies waited on each frame
+		 */
+		uint32_t numAwakeDependencies;
+
+		/**
+		 * The number of dependencies yet to finish pre updating this frame
+		 */
+		std::atomic<uint32_t> pendingPreUpdateDependencies;
+
+		/**
+		 * The number of dependencies yet to finish updating this frame
+		 */
+		std::atomic<uint32_t> pendingUpdateDependencies;
+
+		/**
+		 * The scene holding this node, nullptr if the node is not held by a scene
+		 */
+		Scene* owningScene;
+
+		/**
+		 * Whether or not this node is asleep and left out of pre updates and updates
+		 */
+		bool sleeping;
+
+		/**
+		 * Whether or not this node has been woken since it was last checked for dormancy, keeping it awake for another frame
+		 */
+		std::atomic<bool> wakeRequested;
+
+		/**
+		 * The interval in microseconds between updates, 0 if the node updates every frame
+		 */
+		float updateInterval;
+
+		/**
+		 * The delay in microseconds before the update after the next, negative if no update is deferred
+		 */
+		float nextUpdateDelay;
+
+		/**
+		 * The delay in microseconds this node sleeps for once found idle after its last update, 0 if it sleeps until woken
+		 */
+		float sleepDelay;
+
+		/**
+		 * Whether or not the next update was deferred for update level of detail, the node is then woken early once lodBounds
+		 * falls into a nearer level of detail tier
+		 */
+		bool lodDeferred;
+
+		/**
+		 * The world space bounding box the next update was deferred for by update level of detail
+		 */
+		Rect lodBounds;
+
+		/**
+		 * The scene time in microseconds of this node's last update, used to pass the full time since the last update
+		 */
+		double lastUpdateTime;
+
+		/**
+		 * Incremented whenever this node is put to sleep on a timer or woken, so outdated timers are ignored
+		 */
+		uint32_t timerGeneration;
+
+		/**
+		 * The behaviors currently running on this node
+		 */
+		std::vector<Behavior> behaviors;
+
+		/**
+		 * Gives every running behavior the chance to resume, called after each update. Finished behaviors are removed and
+		 * exceptions thrown out of behaviors are logged.
+		 * @param deltaTime The time in microseconds since the last update
+		 * @returns The time in microseconds until a behavior may next resume, 0 if one must be resumed next update and infinity
+		 * if no behaviors remain
+		 */
+		float runBehaviors(float deltaTime);
+
 	protected:
 
 		/**
@@ -76,6 +199,42 @@ namespace Kale {
 		 */
 		virtual void end(const Scene& scene);
 
+		/**
+		 * Gets the nodes which must finish pre updating before this node pre updates, and finish updating before this node updates.
+		 * The scene reads the dependencies whenever its nodes change, dependencies not within the scene are ignored.
+		 * @returns The nodes this node depends on
+		 */
+		virtual std::vector<Node*> getUpdateDependencies() const;
+
+		/**
+		 * Checks whether or not the node has nothing left to simulate, called after each update. Dormant nodes are put to sleep
+		 * and skip pre updates and updates until woken by Node::wake.
+		 * @returns Whether or not the node is dormant, false by default so nodes are always updated
+		 */
+		virtual bool isDormant() const;
+
+		/**
+		 * Starts running a behavior on this node. The behavior first runs right after this node's next update, or after the
+		 * current update when started from within update. Must only be called from the thread currently updating this node, or
+		 * from the main thread while no updates are running.
+		 * @param behavior The behavior to run
+		 */
+		void startBehavior(Behavior behavior);
+
+		/**
+		 * Copies any state used by render into a snapshot, guaranteed to be called from the main thread while no updates are running.
+		 * Nodes which override render must only read state captured here, as in pipelined rendering render runs while the
+		 * next frame updates.
+		 */
+		virtual void takeRenderSnapshot();
+
+		/**
+		 * Blends the previous and current render snapshots for fixed timestep rendering, guaranteed to be called from the main
+		 * thread prior to rendering. Only called when the application runs with a fixed update rate.
+		 * @param alpha How far between the previous (0) and current (1) snapshot the rendered frame lies
+		 */
+		virtual void interpolateRenderSnapshot(float alpha);
+
 		/**
 		 * Creates the node parent
 		 */
@@ -100,7 +259,8 @@ namespace Kale {
 		/**
 		 * The amount of time (in microseconds) this node takes to update on average
 		 * 
-		 * You can gain this statistic using the Kale Editor calibration tools.
+		 * You can gain this statistic using the Kale Editor calibration tools. This is only used as the initial estimate, the scene
+		 * measures the real update time of every node at runtime and balances threads based off of the measured average.
 		 * This measure is device specific, when developing on multiple devices it is recommended that you use
 		 * a low powered device for calibration, the same device must be used for calibrating all nodes
 		 * to avoid potential bias 
@@ -111,5 +271,60 @@ namespace Kale {
 		 * The amount of time this node takes to pre-update on average, measured and used similarly to updateTime.
 		 */
 		const float preUpdateTime = 100.0f;
+
+		/**
+		 * Gets the measured average time this node takes to update. Until the node has been updated this is updateTime.
+		 * Should only be read outside of updates (e.g. from the main thread) to avoid data races.
+		 * @returns The average update time in microseconds
+		 */
+		float getAverageUpdateTime() const;
+
+		/**
+		 * Gets the measured average time this node takes to pre update. Until the node has been pre updated this is preUpdateTime.
+		 * Should only be read outside of updates (e.g. from the main thread) to avoid data races.
+		 * @returns The average pre update time in microseconds
+		 */
+		float getAveragePreUpdateTime() const;
+
+		/**
+		 * Wakes the node if it is asleep, so it is pre updated and updated again from the next frame along with every node depending
+		 * on it. Must be called after any property write the node's pre update or update must respond to. Can be called from the main
+		 * thread or from any update thread during updates.
+		 */
+		void wake();
+
+		/**
+		 * Sets the interval between updates of this node. The node sleeps between updates and each pre update & update is passed the
+		 * full time since the node's last update. Takes effect after the node's next update.
+		 * @param interval The interval in microseconds, 0 to update every frame
+		 */
+		void setUpdateInterval(float interval);
+
+		/**
+		 * Sets the rate this node is updated at, please see Node::setUpdateInterval for documentation
+		 * @param rate The number of updates per second, 0 to update every frame
+		 */
+		void setUpdateRate(float rate);
+
+		/**
+		 * Gets the interval between updates of this node
+		 * @returns The interval in microseconds, 0 if the node updates every frame
+		 */
+		float getUpdateInterval() const;
+
+		/**
+		 * Defers the node's following update, once the current update finishes the node sleeps for the given delay regardless of its
+		 * update interval. Should be called from the node's own pre update or update.
+		 * @param delay The delay in microseconds
+		 */
+		void scheduleNextUpdate(float delay);
+
+		/**
+		 * Defers the node's following update for update level of detail, please see Node::scheduleNextUpdate for documentation. The
+		 * node is woken early when the bounding box moves into a nearer level of detail tier, such as when it is scrolled into view.
+		 * @param delay The delay in microseconds, usually from Scene::getUpdateLODInterval
+		 * @param boundingBox The world space bounding box of the node the delay was found for
+		 */
+		void scheduleNextUpdate(float delay, const Rect& boundingBox);
 	};
 }
@@ -0,0 +1,372 @@
+/*
+   Copyright 2022 Rishi Challa
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+	   http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+
+#ifdef KALE_OPENGL
+
+#include "PathBatch.hpp"
+
+#include <Kale/Core/Logger/Logger.hpp>
+#include <Kale/Engine/Utils/Utils.hpp>
+
+#include <array>
+#include <algorithm>
+#include <iterator>
+#include <string>
+#include <bit>
+#include <cmath>
+#include <utility>
+#include <initializer_list>
+#include <cstdint>
+
+using namespace Kale;
+
+/**
+ * The number of texels the bezier storage starts with once any path is uploaded
+ */
+static constexpr size_t minBezierTexels = 4096;
+
+/**
+ * The maximum number of tiles along each side of a path's tile grid
+ */
+static constexpr int32_t maxTilesPerSide = 64;
+
+/**
+ * Splits a bezier where it turns around in y, so every segment crosses any horizontal line at most once
+ * @param bezier The bezier to split
+ * @param segments The vector to add the segments to
+ */
+static void splitYMonotonic(const CubicBezier& bezier, std::vector<CubicBezier>& segments) {
+	// The derivative of y is a quadratic in t
+	const float d0 = bezier.controlPoint1.y - bezier.start.y;
+	const float d1 = bezier.controlPoint2.y - bezier.controlPoint1.y;
+	const float d2 = bezier.end.y - bezier.controlPoint2.y;
+	const float a = d0 - 2.0f * d1 + d2;
+	const float b = 2.0f * (d1 - d0);
+	const float c = d0;
+
+	constexpr float epsilon = 1e-6f;
+	std::array<float, 2> roots;
+	size_t numRoots = 0;
+	const auto addRoot = [&](float t) {
+		if (t > epsilon && t < 1.0f - epsilon) roots[numRoots++] = t;
+	};
+	if (std::abs(a) < epsilon) {
+		if (std::abs(b) > epsilon) addRoot(-c / b);
+	}
+	else {
+		float discriminant = b * b - 4.0f * a * c;
+		if (discriminant > 0.0f) {
+			float root = std::sqrt(discriminant);
+			addRoot((-b - root) / (2.0f * a));
+			addRoot((-b + root) / (2.0f * a));
+		}
+	}
+	if (numRoots == 2 && roots[0] > roots[1]) std::swap(roots[0], roots[1]);
+
+	// Split at each turning point, rescaling the later times to the remaining bezier
+	CubicBezier rest = bezier;
+	float consumed = 0.0f;
+	for (size_t i = 0; i < numRoots; i++) {
+		std::pair<CubicBezier, CubicBezier> split = splitBezier(rest, (roots[i] - consumed) / (1.0f - consumed));
+		segments.push_back(split.first);
+		rest = split.second;
+		consumed = roots[i];
+	}
+	segments.push_back(rest);
+}
+
+/**
+ * Creates a path batch, loading its shaders
+ * @param vertShaderPath The path of the vertex shader
+ * @param fragShaderPath The path of the fragment shader
+ */
+PathBatch::PathBatch(const std::string& vertShaderPath, const std::string& fragShaderPath) :
+	instanceBuffer(OpenGL::TextureBufferFormat::RGBA32F), bezierBuffer(OpenGL::TextureBufferFormat::RGBA32F), bezierEnd(0),
+	maxTexels(OpenGL::TextureBuffer<Vector4f>::getMaxSize()) {
+
+	// Load the shaders
+	shader = std::make_unique<const OpenGL::Shader>(vertShaderPath.c_str(), fragShaderPath.c_str());
+
+	// Get the uniform & attribute locations
+	cameraUniform = static_cast<unsigned int>(shader->getUniformLocation("camera"));
+	instancesUniform = static_cast<unsigned int>(shader->getUniformLocation("instances"));
+	beziersUniform = static_cast<unsigned int>(shader->getUniformLocation("beziers"));
+	cornerAttribute = static_cast<unsigned int>(shader->getAttributeLocation("corner"));
+
+	// The vertex shader stretches the unit quad over each path's bounding box
+	const std::array<Vector2f, 4> corners = {Vector2f(0.0f, 0.0f), Vector2f(0.0f, 1.0f), Vector2f(1.0f, 0.0f), Vector2f(1.0f, 1.0f)};
+	const std::array<unsigned int, 6> indices = {0, 1, 2, 1, 3, 2};
+	quad = std::make_unique<OpenGL::VertexArray<Vector2f, 2>>(corners, indices, OpenGL::BufferUsage::Static);
+	quad->enableAttributePointer({cornerAttribute});
+}
+
+/**
+ * Allocates a range of the bezier storage, growing the storage if no free range is large enough
+ * @param numTexels The number of texels to allocate
+ * @returns The offset of the range, or nullopt if the storage can't grow any larger
+ */
+std::optional<size_t> PathBatch::allocate(size_t numTexels) {
+	// Reuse the first free range large enough, keeping what is left of it free
+	for (auto it = freeRanges.begin(); it != freeRanges.end(); it++) {
+		if (it->second < numTexels) continue;
+		size_t offset = it->first;
+		size_t remaining = it->second - numTexels;
+		freeRanges.erase(it);
+		if (remaining > 0) freeRanges.emplace(offset + numTexels, remaining);
+		return offset;
+	}
+
+	// Append to the end of the storage, doubling the storage when it is full so growing is rare
+	if (numTexels > maxTexels - bezierEnd) return std::nullopt;
+	size_t offset = bezierEnd;
+	bezierEnd += numTexels;
+	if (bezierEnd > bezierBuffer.size())
+		bezierBuffer.reserve(std::min(maxTexels, std::max({bezierEnd, bezierBuffer.size() * 2, minBezierTexels})), OpenGL::BufferUsage::Dynamic);
+	return offset;
+}
+
+/**
+ * Frees a range of the bezier storage
+ * @param offset The offset of the range
+ * @param numTexels The number of texels within the range
+ */
+void PathBatch::deallocate(size_t offset, size_t numTexels) {
+	if (numTexels == 0) return;
+
+	// Merge with the free ranges directly before and after
+	auto next = freeRanges.lower_bound(offset);
+	if (next != freeRanges.end() && next->first == offset + numTexels) {
+		numTexels += next->second;
+		next = freeRanges.erase(next);
+	}
+	if (next != freeRanges.begin()) {
+		auto prev = std::prev(next);
+		if (prev->first + prev->second == offset) {
+			offset = prev->first;
+			numTexels += prev->second;
+			freeRanges.erase(prev);
+		}
+	}
+
+	// A range at the end of the storage shrinks the storage in use instead
+	if (offset + numTexels == bezierEnd) bezierEnd = offset;
+	else freeRanges.emplace(offset, numTexels);
+}
+
+/**
+ * Bins the segments into a grid of tiles, appending the grid to the packed texels. The grid starts with its origin & tile size,
+ * then its number of columns & rows, then a texel per tile holding the position of its first listed segment, its number of listed
+ * segments & its winding offset, then the listed segments packed four to a texel.
+ * @param strokeRadius The radius of the path's stroke, 0 if the path isn't stroked
+ */
+void PathBatch::binSegments(float strokeRadius) {
+	// The grid covers every control point and the stroke around them
+	Vector2f min = segments.front().start;
+	Vector2f max = min;
+	for (const CubicBezier& segment : segments) {
+		for (const Vector2f& point : {segment.start, segment.controlPoint1, segment.controlPoint2, segment.end}) {
+			min = Vector2f(std::min(min.x, point.x), std::min(min.y, point.y));
+			max = Vector2f(std::max(max.x, point.x), std::max(max.y, point.y));
+		}
+	}
+	min -= strokeRadius;
+	max += strokeRadius;
+
+	// Around the square root of the number of segments along each side, leaving a handful of segments per tile
+	const int32_t tilesPerSide = std::clamp(static_cast<int32_t>(std::ceil(std::sqrt(static_cast<float>(segments.size())))),
+		1, maxTilesPerSide);
+	const int32_t cols = tilesPerSide;
+	const int32_t rows = tilesPerSide;
+	Vector2f tileSize = (max - min) / static_cast<float>(tilesPerSide);
+	if (tileSize.x <= 0.0f) tileSize.x = 1.0f;
+	if (tileSize.y <= 0.0f) tileSize.y = 1.0f;
+	const auto colAt = [&](float x) -> int32_t {
+		return std::clamp(static_cast<int32_t>(std::floor((x - min.x) / tileSize.x)), 0, cols - 1);
+	};
+	const auto rowAt = [&](float y) -> int32_t {
+		return std::clamp(static_cast<int32_t>(std::floor((y - min.y) / tileSize.y)), 0, rows - 1);
+	};
+
+	// Lists each segment within the tiles it can affect. Tiles near the segment test it for both filling & stroking, tiles to the
+	// left of it only for filling. A segment spanning a whole row crosses the ray of every fragment to its left exactly once, so it
+	// is counted within the winding offsets of those tiles rather than listed.
+	const auto visit = [&](auto&& list, bool countWindings) {
+		for (int32_t i = 0; i < static_cast<int32_t>(segments.size()); i++) {
+			const CubicBezier& segment = segments[static_cast<size_t>(i)];
+			float minX = std::min({segment.start.x, segment.controlPoint1.x, segment.controlPoint2.x, segment.end.x});
+			float maxX = std::max({segment.start.x, segment.controlPoint1.x, segment.controlPoint2.x, segment.end.x});
+			float minY = std::min({segment.start.y, segment.controlPoint1.y, segment.controlPoint2.y, segment.end.y});
+			float maxY = std::max({segment.start.y, segment.controlPoint1.y, segment.controlPoint2.y, segment.end.y});
+			float spanMinY = std::min(segment.start.y, segment.end.y);
+			float spanMaxY = std::max(segment.start.y, segment.end.y);
+
+			int32_t colLow = colAt(minX - strokeRadius);
+			int32_t colHigh = colAt(maxX + strokeRadius);
+			for (int32_t row = rowAt(minY - strokeRadius); row <= rowAt(maxY + strokeRadius); row++) {
+				for (int32_t col = colLow; col <= colHigh; col++) list(row * cols + col, i);
+
+				float rowMinY = min.y + static_cast<float>(row) * tileSize.y;
+				float rowMaxY = rowMinY + tileSize.y;
+				if (maxY < rowMinY || minY > rowMaxY || colLow == 0) continue;
+				if (spanMinY <= rowMinY && spanMaxY >= rowMaxY) {
+					if (!countWindings) continue;
+					windingSteps[static_cast<size_t>(row * cols)]++;
+					windingSteps[static_cast<size_t>(row * cols + colLow)]--;
+				}
+				else for (int32_t col = 0; col < colLow; col++) list(row * cols + col, i);
+			}
+		}
+	};
+
+	// Count the segments within each tile, then place them with each tile's start advancing to the next tile's start
+	const size_t numTiles = static_cast<size_t>(cols * rows);
+	tileStarts.assign(numTiles, 0);
+	windingSteps.assign(numTiles, 0);
+	visit([&](int32_t tile, int32_t segment) { tileStarts[static_cast<size_t>(tile)]++; }, true);
+	int32_t total = 0;
+	for (int32_t& start : tileStarts) {
+		int32_t count = start;
+		start = total;
+		total += count;
+	}
+	tileSegments.resize(static_cast<size_t>(total));
+	visit([&](int32_t tile, int32_t segment) { tileSegments[static_cast<size_t>(tileStarts[static_cast<size_t>(tile)]++)] = segment; }, false);
+
+	// Pack the grid, positions of listed segments are counted in integers from the start of the path's range
+	const size_t tileOffset = packedTexels.size();
+	const int32_t firstListed = static_cast<int32_t>((tileOffset + 2 + numTiles) * 4);
+	packedTexels.push_back(Vector4f(min.x, min.y, tileSize.x, tileSize.y));
+	packedTexels.push_back(Vector4f(std::bit_cast<float>(cols), std::bit_cast<float>(rows), 0.0f, 0.0f));
+	for (int32_t row = 0; row < rows; row++) {
+		int32_t winding = 0;
+		for (int32_t col = 0; col < cols; col++) {
+			size_t tile = static_cast<size_t>(row * cols + col);
+			int32_t start = tile == 0 ? 0 : tileStarts[tile - 1];
+			winding += windingSteps[tile];
+			packedTexels.push_back(Vector4f(std::bit_cast<float>(firstListed + start), std::bit_cast<float>(tileStarts[tile] - start),
+				std::bit_cast<float>(winding), 0.0f));
+		}
+	}
+	for (size_t i = 0; i < tileSegments.size(); i += 4) {
+		std::array<int32_t, 4> packed = {0, 0, 0, 0};
+		std::copy(tileSegments.begin() + static_cast<std::ptrdiff_t>(i),
+			tileSegments.begin() + static_cast<std::ptrdiff_t>(std::min(i + 4, tileSegments.size())), packed.begin());
+		packedTexels.push_back(Vector4f(std::bit_cast<float>(packed[0]), std::bit_cast<float>(packed[1]), std::bit_cast<float>(packed[2]),
+			std::bit_cast<float>(packed[3])));
+	}
+}
+
+/**
+ * Uploads a path's beziers to its range of the bezier storage binned into tiles, reallocating the range when they don't fit.
+ * Should only be called when the path or its stroke changes.
+ * @param range The path's range, empty if the path has never been uploaded
+ * @param pathBeziers The beziers of the path
+ * @param strokeRadius The radius of the path's stroke, 0 if the path isn't stroked
+ */
+void PathBatch::upload(BezierRange& range, const std::vector<CubicBezier>& pathBeziers, float strokeRadius) {
+	segments.clear();
+	for (const CubicBezier& bezier : pathBeziers) splitYMonotonic(bezier, segments);
+
+	packedTexels.clear();
+	for (const CubicBezier& segment : segments) {
+		packedTexels.push_back(Vector4f(segment.start.x, segment.start.y, segment.controlPoint1.x, segment.controlPoint1.y));
+		packedTexels.push_back(Vector4f(segment.controlPoint2.x, segment.controlPoint2.y, segment.end.x, segment.end.y));
+	}
+	const size_t tileOffset = packedTexels.size();
+	if (!segments.empty()) binSegments(strokeRadius);
+
+	size_t numTexels = packedTexels.size();
+	if (numTexels > range.capacity) {
+		release(range);
+		std::optional<size_t> offset = allocate(numTexels);
+		if (!offset.has_value()) {
+			console.warn("Path with " + std::to_string(pathBeziers.size()) + " beziers exceeds the texture buffer size and is not drawn");
+			return;
+		}
+		range.offset = *offset;
+		range.capacity = numTexels;
+	}
+
+	if (numTexels > 0) bezierBuffer.update(range.offset, packedTexels.data(), numTexels);
+	range.numSegments = segments.size();
+	range.tileOffset = tileOffset;
+}
+
+/**
+ * Frees a path's range of the bezier storage
+ * @param range The path's range, emptied
+ */
+void PathBatch::release(BezierRange& range) {
+	deallocate(range.offset, range.capacity);
+	range = BezierRange();
+}
+
+/**
+ * Adds a path to be drawn when the batch is next rendered
+ * @param transform The full transform of the path
+ * @param boundingBox The local bounding box of the path, including the stroke
+ * @param range The path's range of the bezier storage
+ * @param color The fill color
+ * @param strokeColor The stroke color
+ * @param zPosition The z position
+ * @param strokeRadius The radius of the stroke
+ * @param fill Whether or not to fill the path
+ * @param stroke The stroke style, Neither = 0, Both = 1, Inside = 2, Outside = 3
+ */
+void PathBatch::add(const Transform& transform, const Rect& boundingBox, const BezierRange& range, const Color& color,
+	const Color& strokeColor, float zPosition, float strokeRadius, bool fill, int stroke) {
+	if (range.numSegments == 0) return;
+
+	// Offsets are stored as integer bits so they stay exact past the precision of a float
+	const int32_t bezierOffset = static_cast<int32_t>(range.offset);
+	const int32_t tileOffset = static_cast<int32_t>(range.tileOffset);
+	instances.push_back(Vector4f(transform.data[0], transform.data[1], transform.data[2], zPosition));
+	instances.push_back(Vector4f(transform.data[3], transform.data[4], transform.data[5], strokeRadius));
+	instances.push_back(Vector4f(boundingBox.topLeft.x, boundingBox.topLeft.y, boundingBox.bottomRight.x, boundingBox.bottomRight.y));
+	instances.push_back(color);
+	instances.push_back(strokeColor);
+	instances.push_back(Vector4f(std::bit_cast<float>(bezierOffset), std::bit_cast<float>(tileOffset),
+		std::bit_cast<float>(static_cast<int32_t>(fill)), std::bit_cast<float>(static_cast<int32_t>(stroke))));
+}
+
+/**
+ * Draws every path added since the last render and clears the batch
+ * @param camera The camera to render with
+ */
+void PathBatch::render(const Camera& camera) {
+	if (instances.empty()) return;
+
+	shader->useProgram();
+	shader->uniform(cameraUniform, camera);
+	shader->uniform(instancesUniform, 0);
+	shader->uniform(beziersUniform, 1);
+	instanceBuffer.bind(0);
+	bezierBuffer.bind(1);
+
+	// Only the per path data is uploaded each frame, usually within a single draw call. The instance buffer is orphaned by each
+	// upload so earlier draws are not waited on.
+	const size_t maxInstanceTexels = maxTexels - maxTexels % texelsPerInstance;
+	for (size_t first = 0; first < instances.size(); first += maxInstanceTexels) {
+		size_t count = std::min(maxInstanceTexels, instances.size() - first);
+		instanceBuffer.upload(instances.data() + first, count, OpenGL::BufferUsage::Dynamic);
+		quad->drawInstanced(count / texelsPerInstance);
+	}
+
+	instances.clear();
+}
+
+#endif
@@ -0,0 +1,243 @@
+/*
+   Copyright 2022 Rishi Challa
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+	   http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+
+#pragma once
+
+#ifdef KALE_OPENGL
+
+#include <Kale/Math/Path/Path.hpp>
+#include <Kale/Math/Rect/Rect.hpp>
+#include <Kale/Math/Transform/Transform.hpp>
+#include <Kale/Math/Vector/Vector.hpp>
+#include <Kale/OpenGL/Shader/Shader.hpp>
+#include <Kale/OpenGL/TextureBuffer/TextureBuffer.hpp>
+#include <Kale/OpenGL/VertexArray/VertexArray.hpp>
+
+#include <memory>
+#include <map>
+#include <optional>
+#include <vector>
+#include <string>
+#include <cstddef>
+#include <cstdint>
+
+namespace Kale {
+
+	/**
+	 * Collects the paths rendered within a frame and draws them all at once. Each path's transform, bounding box and style are
+	 * packed into a texture buffer every frame, then a unit quad is drawn instanced once per path with the vertex shader placing
+	 * each instance over its path's bounding box. Paths are drawn in the order they are added.
+	 *
+	 * The beziers of every path are kept on the GPU within a second texture buffer, each path owning a range of it which is only
+	 * uploaded when the path changes. The number of beziers within a path is limited only by the device's maximum texture buffer
+	 * size.
+	 *
+	 * When uploaded the beziers are split into segments monotonic in y and binned into a grid of tiles over the path. Each tile
+	 * holds the segments which can affect its fragments along with the number of segments entirely to its right crossing its whole
+	 * row, so the fragment shader only tests the segments near each fragment rather than every bezier of the path.
+	 */
+	class PathBatch {
+	public:
+
+		/**
+		 * A path's range of the GPU bezier storage
+		 */
+		struct BezierRange {
+
+			/**
+			 * The index of the first texel of the range
+			 */
+			size_t offset = 0;
+
+			/**
+			 * The number of texels allocated to the range
+			 */
+			size_t capacity = 0;
+
+			/**
+			 * The number of y monotonic segments held within the range, two texels each
+			 */
+			size_t numSegments = 0;
+
+			/**
+			 * The offset of the tile grid from the start of the range, following the segments
+			 */
+			size_t tileOffset = 0;
+		};
+
+	private:
+
+		/**
+		 * The shader used for rendering
+		 */
+		std::unique_ptr<const OpenGL::Shader> shader;
+
+		/**
+		 * The location of the uniform within the shader
+		 */
+		unsigned int cameraUniform, instancesUniform, beziersUniform;
+
+		/**
+		 * The location of the attribute within the shader
+		 */
+		unsigned int cornerAttribute;
+
+		/**
+		 * The unit quad drawn once for each path
+		 */
+		std::unique_ptr<OpenGL::VertexArray<Vector2f, 2>> quad;
+
+		/**
+		 * The per path data read by the shader
+		 */
+		OpenGL::TextureBuffer<Vector4f> instanceBuffer;
+
+		/**
+		 * The beziers of every path read by the shader, two texels per bezier
+		 */
+		OpenGL::TextureBuffer<Vector4f> bezierBuffer;
+
+		/**
+		 * The unallocated ranges of the bezier storage before its end, the offset of each range mapped to its size
+		 */
+		std::map<size_t, size_t> freeRanges;
+
+		/**
+		 * The index past the last allocated texel of the bezier storage
+		 */
+		size_t bezierEnd;
+
+		/**
+		 * Used for packing a path's segments and tiles into texels before uploading them
+		 */
+		std::vector<Vector4f> packedTexels;
+
+		/**
+		 * Used for holding a path's y monotonic segments while binning them
+		 */
+		std::vector<CubicBezier> segments;
+
+		/**
+		 * Used for holding the number of segments listed within each tile, then the index of each tile's first listed segment
+		 */
+		std::vector<int32_t> tileStarts;
+
+		/**
+		 * Used for holding the change in the winding offset between each tile and the tile to its left
+		 */
+		std::vector<int32_t> windingSteps;
+
+		/**
+		 * Used for holding the segments listed within every tile, tile by tile
+		 */
+		std::vector<int32_t> tileSegments;
+
+		/**
+		 * The per path data of the paths added this frame
+		 */
+		std::vector<Vector4f> instances;
+
+		/**
+		 * The maximum number of texels within a texture buffer on this device
+		 */
+		size_t maxTexels;
+
+		/**
+		 * Bins the segments into a grid of tiles, appending the grid to the packed texels. The grid starts with its origin & tile
+		 * size, then its number of columns & rows, then a texel per tile holding the position of its first listed segment, its
+		 * number of listed segments & its winding offset, then the listed segments packed four to a texel.
+		 * @param strokeRadius The radius of the path's stroke, 0 if the path isn't stroked
+		 */
+		void binSegments(float strokeRadius);
+
+		/**
+		 * Allocates a range of the bezier storage, growing the storage if no free range is large enough
+		 * @param numTexels The number of texels to allocate
+		 * @returns The offset of the range, or nullopt if the storage can't grow any larger
+		 */
+		std::optional<size_t> allocate(size_t numTexels);
+
+		/**
+		 * Frees a range of the bezier storage
+		 * @param offset The offset of the range
+		 * @param numTexels The number of texels within the range
+		 */
+		void deallocate(size_t offset, size_t numTexels);
+
+	public:
+
+		/**
+		 * The number of texels of per path data
+		 */
+		static constexpr size_t texelsPerInstance = 6;
+
+		/**
+		 * Creates a path batch, loading its shaders
+		 * @param vertShaderPath The path of the vertex shader
+		 * @param fragShaderPath The path of the fragment shader
+		 */
+		PathBatch(const std::string& vertShaderPath, const std::string& fragShaderPath);
+
+		/**
+		 * Path batches do not support copying
+		 */
+		PathBatch(const PathBatch& other) = delete;
+
+		/**
+		 * Path batches do not support copying
+		 */
+		void operator=(const PathBatch& other) = delete;
+
+		/**
+		 * Uploads a path's beziers to its range of the bezier storage binned into tiles, reallocating the range when they don't
+		 * fit. Should only be called when the path or its stroke changes.
+		 * @param range The path's range, empty if the path has never been uploaded
+		 * @param pathBeziers The beziers of the path
+		 * @param strokeRadius The radius of the path's stroke, 0 if the path isn't stroked
+		 */
+		void upload(BezierRange& range, const std::vector<CubicBezier>& pathBeziers, float strokeRadius);
+
+		/**
+		 * Frees a path's range of the bezier storage
+		 * @param range The path's range, emptied
+		 */
+		void release(BezierRange& range);
+
+		/**
+		 * Adds a path to be drawn when the batch is next rendered
+		 * @param transform The full transform of the path
+		 * @param boundingBox The local bounding box of the path, including the stroke
+		 * @param range The path's range of the bezier storage
+		 * @param color The fill color
+		 * @param strokeColor The stroke color
+		 * @param zPosition The z position
+		 * @param strokeRadius The radius of the stroke
+		 * @param fill Whether or not to fill the path
+		 * @param stroke The stroke style, Neither = 0, Both = 1, Inside = 2, Outside = 3
+		 */
+		void add(const Transform& transform, const Rect& boundingBox, const BezierRange& range, const Color& color,
+			const Color& strokeColor, float zPosition, float strokeRadius, bool fill, int stroke);
+
+		/**
+		 * Draws every path added since the last render and clears the batch
+		 * @param camera The camera to render with
+		 */
+		void render(const Camera& camera);
+	};
+}
+
+#endif
@@ -0,0 +1,109 @@
+/*
+   Copyright 2022 Rishi Challa
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+	   http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+
+#ifdef KALE_OPENGL
+
+#include "PathCurveMesh.hpp"
+
+#include <algorithm>
+#include <array>
+#include <utility>
+#include <vector>
+
+using namespace Kale;
+
+/**
+ * Loads the shader every curve mesh is drawn with
+ * @param vertShaderPath The path of the vertex shader
+ * @param fragShaderPath The path of the fragment shader
+ */
+void PathCurveMesh::setup(const std::string& vertShaderPath, const std::string& fragShaderPath) {
+	shader = std::make_unique<const OpenGL::Shader>(vertShaderPath.c_str(), fragShaderPath.c_str());
+	cameraUniform = static_cast<unsigned int>(shader->getUniformLocation("camera"));
+	zPositionUniform = static_cast<unsigned int>(shader->getUniformLocation("zPosition"));
+	colorUniform = static_cast<unsigned int>(shader->getUniformLocation("color"));
+	positionAttribute = static_cast<unsigned int>(shader->getAttributeLocation("position"));
+	klmAttribute = static_cast<unsigned int>(shader->getAttributeLocation("klm"));
+}
+
+/**
+ * Frees the shader every curve mesh is drawn with
+ */
+void PathCurveMesh::cleanup() {
+	shader.reset();
+}
+
+/**
+ * Creates a curve mesh filling a path, which only needs to be created again when the path changes
+ * @param path The path to fill
+ */
+PathCurveMesh::PathCurveMesh(const Path& path) {
+	std::pair<std::vector<CurveVertex>, std::vector<unsigned int>> curves = triangulateCurves(path);
+	if (curves.second.empty()) return;
+
+	triangles = std::make_unique<OpenGL::VertexArray<CurveVertex, 2, 3>>(curves.first, std::move(curves.second),
+		OpenGL::BufferUsage::Static);
+	triangles->enableAttributePointer({positionAttribute, klmAttribute});
+
+	// The beziers lie within the bounds of their control points
+	Vector2f min = curves.first.front().position;
+	Vector2f max = min;
+	for (const CurveVertex& vertex : curves.first) {
+		min = Vector2f(std::min(min.x, vertex.position.x), std::min(min.y, vertex.position.y));
+		max = Vector2f(std::max(max.x, vertex.position.x), std::max(max.y, vertex.position.y));
+	}
+	const Vector3f solid(0.0f, 1.0f, 1.0f);
+	const std::array<CurveVertex, 4> corners = {CurveVertex{min, solid}, CurveVertex{Vector2f(max.x, min.y), solid}, CurveVertex{max, solid},
+		CurveVertex{Vector2f(min.x, max.y), solid}};
+	const std::array<unsigned int, 6> indices = {0, 1, 2, 0, 2, 3};
+	cover = std::make_unique<OpenGL::VertexArray<CurveVertex, 2, 3>>(corners, indices, OpenGL::BufferUsage::Static);
+	cover->enableAttributePointer({positionAttribute, klmAttribute});
+}
+
+/**
+ * Draws the mesh
+ * @param camera The camera to render with, including the transform of the path
+ * @param zPosition The z position to draw at
+ * @param color The fill color
+ */
+void PathCurveMesh::render(const Camera& camera, float zPosition, const Color& color) const {
+	if (triangles == nullptr) return;
+
+	shader->useProgram();
+	shader->uniform(cameraUniform, camera);
+	shader->uniform(zPositionUniform, zPosition);
+	shader->uniform(colorUniform, color);
+	glEnable(GL_STENCIL_TEST);
+
+	// Invert the stencil of every covered fragment, even those behind other nodes as the cover is depth tested instead
+	glColorMask(GL_FALSE, GL_FALSE, GL_FALSE, GL_FALSE);
+	glDepthMask(GL_FALSE);
+	glStencilFunc(GL_ALWAYS, 0, 0xFF);
+	glStencilOp(GL_KEEP, GL_INVERT, GL_INVERT);
+	triangles->draw();
+
+	// Color the fragments covered an odd number of times, zeroing the stencil for the next path
+	glColorMask(GL_TRUE, GL_TRUE, GL_TRUE, GL_TRUE);
+	glDepthMask(GL_TRUE);
+	glStencilFunc(GL_NOTEQUAL, 0, 0xFF);
+	glStencilOp(GL_ZERO, GL_ZERO, GL_ZERO);
+	cover->draw();
+
+	glDisable(GL_STENCIL_TEST);
+}
+
+#endif
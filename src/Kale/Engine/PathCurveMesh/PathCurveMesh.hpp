@@ -0,0 +1,98 @@
+/*
+   Copyright 2022 Rishi Challa
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+	   http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+
+#pragma once
+
+#ifdef KALE_OPENGL
+
+#include <Kale/Engine/Utils/Utils.hpp>
+#include <Kale/Math/Path/Path.hpp>
+#include <Kale/Math/Transform/Transform.hpp>
+#include <Kale/Math/Vector/Vector.hpp>
+#include <Kale/OpenGL/Shader/Shader.hpp>
+#include <Kale/OpenGL/VertexArray/VertexArray.hpp>
+
+#include <memory>
+#include <string>
+
+namespace Kale {
+
+	/**
+	 * Triangles filling a path with the implicit form of each bezier evaluated per fragment, staying sharp at any zoom while the
+	 * cost per fragment doesn't depend on the number of beziers. The triangles are drawn into the stencil buffer inverting every
+	 * fragment they cover, leaving the fragments within the path by the even odd rule set, then the path's bounding box is drawn
+	 * in color over the set fragments, clearing them again.
+	 */
+	class PathCurveMesh {
+	private:
+
+		/**
+		 * The shader every curve mesh is drawn with
+		 */
+		static inline std::unique_ptr<const OpenGL::Shader> shader = nullptr;
+
+		/**
+		 * The locations of the shader's uniforms
+		 */
+		static inline unsigned int cameraUniform, zPositionUniform, colorUniform;
+
+		/**
+		 * The locations of the shader's vertex position & implicit form coordinate attributes
+		 */
+		static inline unsigned int positionAttribute, klmAttribute;
+
+		/**
+		 * The triangles drawn into the stencil buffer
+		 */
+		std::unique_ptr<OpenGL::VertexArray<CurveVertex, 2, 3>> triangles;
+
+		/**
+		 * The bounding box of the path, drawn over the fragments set within the stencil buffer
+		 */
+		std::unique_ptr<OpenGL::VertexArray<CurveVertex, 2, 3>> cover;
+
+	public:
+
+		/**
+		 * Loads the shader every curve mesh is drawn with
+		 * @param vertShaderPath The path of the vertex shader
+		 * @param fragShaderPath The path of the fragment shader
+		 */
+		static void setup(const std::string& vertShaderPath, const std::string& fragShaderPath);
+
+		/**
+		 * Frees the shader every curve mesh is drawn with
+		 */
+		static void cleanup();
+
+		/**
+		 * Creates a curve mesh filling a path, which only needs to be created again when the path changes
+		 * @param path The path to fill
+		 */
+		PathCurveMesh(const Path& path);
+
+		/**
+		 * Draws the mesh
+		 * @param camera The camera to render with, including the transform of the path
+		 * @param zPosition The z position to draw at
+		 * @param color The fill color
+		 */
+		void render(const Camera& camera, float zPosition, const Color& color) const;
+	};
+}
+
+#endif
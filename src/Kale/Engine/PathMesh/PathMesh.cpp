@@ -0,0 +1,122 @@
+/*
+   Copyright 2022 Rishi Challa
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+	   http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+
+#ifdef KALE_OPENGL
+
+#include "PathMesh.hpp"
+
+#include <Kale/Engine/Utils/Utils.hpp>
+
+#include <algorithm>
+#include <utility>
+#include <vector>
+
+using namespace Kale;
+
+/**
+ * Loads the shader every path mesh is drawn with
+ * @param vertShaderPath The path of the vertex shader
+ * @param fragShaderPath The path of the fragment shader
+ */
+void PathMesh::setup(const std::string& vertShaderPath, const std::string& fragShaderPath) {
+	shader = std::make_unique<const OpenGL::Shader>(vertShaderPath.c_str(), fragShaderPath.c_str());
+	cameraUniform = static_cast<unsigned int>(shader->getUniformLocation("camera"));
+	zPositionUniform = static_cast<unsigned int>(shader->getUniformLocation("zPosition"));
+	colorUniform = static_cast<unsigned int>(shader->getUniformLocation("color"));
+	positionAttribute = static_cast<unsigned int>(shader->getAttributeLocation("position"));
+}
+
+/**
+ * Frees the shader every path mesh is drawn with
+ */
+void PathMesh::cleanup() {
+	shader.reset();
+}
+
+/**
+ * Creates an empty path mesh which must be tessellated
+ */
+PathMesh::PathMesh() : pixelsPerUnit(0.0f) {
+	// Empty Body
+}
+
+/**
+ * Marks the mesh to be tessellated before it is next drawn, for when the path or its style changes
+ */
+void PathMesh::invalidate() {
+	pixelsPerUnit = 0.0f;
+}
+
+/**
+ * Checks whether or not the mesh must be tessellated to be drawn at a scale, when the mesh has been invalidated or the
+ * scale has changed enough that the lines are visibly coarse or needlessly fine
+ * @param pixelsPerUnit The number of pixels per unit of the path it will be drawn at
+ * @returns Whether or not the mesh must be tessellated
+ */
+bool PathMesh::needsTessellation(float pixelsPerUnit) const {
+	// Zooming by up to a factor of two keeps the lines within twice the tolerance, a quarter of the usual retessellations
+	return this->pixelsPerUnit == 0.0f || pixelsPerUnit > this->pixelsPerUnit * 2.0f || pixelsPerUnit < this->pixelsPerUnit * 0.5f;
+}
+
+/**
+ * Tessellates a path into the mesh
+ * @param path The path to tessellate
+ * @param fill Whether or not to fill the path
+ * @param strokeRadius The radius of the stroke, 0 if the path isn't stroked
+ * @param pixelsPerUnit The number of pixels per unit of the path it will be drawn at
+ */
+void PathMesh::tessellate(const Path& path, bool fill, float strokeRadius, float pixelsPerUnit) {
+	this->pixelsPerUnit = pixelsPerUnit;
+	const float localTolerance = tolerance / std::max(pixelsPerUnit, 1e-6f);
+	const std::vector<std::vector<Vector2f>> polylines = flattenPath(path, localTolerance);
+
+	const auto createTriangles = [](std::pair<std::vector<Vector2f>, std::vector<unsigned int>>&& triangles)
+		-> std::unique_ptr<OpenGL::VertexArray<Vector2f, 2>> {
+		if (triangles.second.empty()) return nullptr;
+		auto vertexArray = std::make_unique<OpenGL::VertexArray<Vector2f, 2>>(triangles.first, std::move(triangles.second),
+			OpenGL::BufferUsage::Static);
+		vertexArray->enableAttributePointer({positionAttribute});
+		return vertexArray;
+	};
+	fillTriangles = fill ? createTriangles(triangulateFill(polylines)) : nullptr;
+	strokeTriangles = createTriangles(triangulateStroke(polylines, strokeRadius, localTolerance));
+}
+
+/**
+ * Draws the mesh. The fill and stroke are drawn at the same depth so with depth testing the one drawn first covers the other.
+ * @param camera The camera to render with, including the transform of the path
+ * @param zPosition The z position to draw at
+ * @param color The fill color
+ * @param strokeColor The stroke color
+ * @param strokeOverFill Whether the stroke covers the fill, otherwise the fill covers the stroke
+ */
+void PathMesh::render(const Camera& camera, float zPosition, const Color& color, const Color& strokeColor, bool strokeOverFill) const {
+	shader->useProgram();
+	shader->uniform(cameraUniform, camera);
+	shader->uniform(zPositionUniform, zPosition);
+
+	const auto draw = [&](const std::unique_ptr<OpenGL::VertexArray<Vector2f, 2>>& triangles, const Color& triangleColor) {
+		if (triangles == nullptr) return;
+		shader->uniform(colorUniform, triangleColor);
+		triangles->draw();
+	};
+	if (strokeOverFill) draw(strokeTriangles, strokeColor);
+	draw(fillTriangles, color);
+	if (!strokeOverFill) draw(strokeTriangles, strokeColor);
+}
+
+#endif
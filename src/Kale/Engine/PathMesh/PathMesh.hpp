@@ -0,0 +1,129 @@
+/*
+   Copyright 2022 Rishi Challa
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+	   http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+
+#pragma once
+
+#ifdef KALE_OPENGL
+
+#include <Kale/Math/Path/Path.hpp>
+#include <Kale/Math/Transform/Transform.hpp>
+#include <Kale/Math/Vector/Vector.hpp>
+#include <Kale/OpenGL/Shader/Shader.hpp>
+#include <Kale/OpenGL/VertexArray/VertexArray.hpp>
+
+#include <memory>
+#include <string>
+
+namespace Kale {
+
+	/**
+	 * Triangles tessellated from a path on the CPU, drawn with a shader which only outputs a flat color. Unlike the per pixel bezier
+	 * tests of a path batch the cost is paid once when tessellating, so this suits paths which rarely change. The path is flattened
+	 * to lines within a fraction of a pixel of the curves at the scale it is drawn at, so it must be tessellated again when zoomed.
+	 */
+	class PathMesh {
+	private:
+
+		/**
+		 * The shader every path mesh is drawn with
+		 */
+		static inline std::unique_ptr<const OpenGL::Shader> shader = nullptr;
+
+		/**
+		 * The locations of the shader's uniforms
+		 */
+		static inline unsigned int cameraUniform, zPositionUniform, colorUniform;
+
+		/**
+		 * The location of the shader's vertex position attribute
+		 */
+		static inline unsigned int positionAttribute;
+
+		/**
+		 * The triangles filling the path
+		 */
+		std::unique_ptr<OpenGL::VertexArray<Vector2f, 2>> fillTriangles;
+
+		/**
+		 * The triangles stroking the path
+		 */
+		std::unique_ptr<OpenGL::VertexArray<Vector2f, 2>> strokeTriangles;
+
+		/**
+		 * The number of pixels per unit of the path when it was tessellated, 0 if it must be tessellated
+		 */
+		float pixelsPerUnit;
+
+	public:
+
+		/**
+		 * The maximum distance in pixels between the triangles and the true path
+		 */
+		static constexpr float tolerance = 0.25f;
+
+		/**
+		 * Loads the shader every path mesh is drawn with
+		 * @param vertShaderPath The path of the vertex shader
+		 * @param fragShaderPath The path of the fragment shader
+		 */
+		static void setup(const std::string& vertShaderPath, const std::string& fragShaderPath);
+
+		/**
+		 * Frees the shader every path mesh is drawn with
+		 */
+		static void cleanup();
+
+		/**
+		 * Creates an empty path mesh which must be tessellated
+		 */
+		PathMesh();
+
+		/**
+		 * Marks the mesh to be tessellated before it is next drawn, for when the path or its style changes
+		 */
+		void invalidate();
+
+		/**
+		 * Checks whether or not the mesh must be tessellated to be drawn at a scale, when the mesh has been invalidated or the
+		 * scale has changed enough that the lines are visibly coarse or needlessly fine
+		 * @param pixelsPerUnit The number of pixels per unit of the path it will be drawn at
+		 * @returns Whether or not the mesh must be tessellated
+		 */
+		bool needsTessellation(float pixelsPerUnit) const;
+
+		/**
+		 * Tessellates a path into the mesh
+		 * @param path The path to tessellate
+		 * @param fill Whether or not to fill the path
+		 * @param strokeRadius The radius of the stroke, 0 if the path isn't stroked
+		 * @param pixelsPerUnit The number of pixels per unit of the path it will be drawn at
+		 */
+		void tessellate(const Path& path, bool fill, float strokeRadius, float pixelsPerUnit);
+
+		/**
+		 * Draws the mesh. The fill and stroke are drawn at the same depth so with depth testing the one drawn first covers the other.
+		 * @param camera The camera to render with, including the transform of the path
+		 * @param zPosition The z position to draw at
+		 * @param color The fill color
+		 * @param strokeColor The stroke color
+		 * @param strokeOverFill Whether the stroke covers the fill, otherwise the fill covers the stroke
+		 */
+		void render(const Camera& camera, float zPosition, const Color& color, const Color& strokeColor, bool strokeOverFill) const;
+	};
+}
+
+#endif
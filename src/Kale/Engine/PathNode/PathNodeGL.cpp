@@ -20,8 +20,10 @@
 
 #include <Kale/Engine/Utils/Utils.hpp>
 #include <Kale/Core/Application/Application.hpp>
+#include <Kale/Core/Logger/Logger.hpp>
 
 #include <algorithm>
+#include <cmath>
 
 using namespace Kale;
 
@@ -34,35 +36,35 @@ void PathNode::setup() {
 	Scene::addNodeSaveStateConstructor("PathNode", [](JSON json) -> std::shared_ptr<Node> {
 		return std::make_shared<PathNode>(json);
 	});
-	
-	// Get shader paths
-	const std::string vertShaderPath = mainApp->getAssetFolderPath() + "shaders/PathNode.vert";
-	const std::string fragShaderPath = mainApp->getAssetFolderPath() + "shaders/PathNode.frag";
+	Scene::addNodeBinarySaveState("PathNode", [](BinarySceneReader& reader) -> std::shared_ptr<Node> {
+		return std::make_shared<PathNode>(reader);
+	}, [](const Node& node, BinarySceneWriter& writer) {
+		dynamic_cast<const PathNode&>(node).write(writer);
+	});
 
-	// Load the shaders
-	shader = std::make_unique<const OpenGL::Shader>(vertShaderPath.c_str(), fragShaderPath.c_str());
+	// Draw every path node together once all nodes have rendered
+	Scene::addBatchRenderFunction([](const Camera& camera) {
+		if (batch != nullptr) batch->render(camera);
+	});
 
-	// Get the uniform locations
-	cameraUniform = static_cast<unsigned int>(shader->getUniformLocation("camera"));
-	localUniform = static_cast<unsigned int>(shader->getUniformLocation("local"));
-	vertexColorUniform = static_cast<unsigned int>(shader->getUniformLocation("vertexColor"));
-	strokeColorUniform = static_cast<unsigned int>(shader->getUniformLocation("strokeColor"));
-	zPositionUniform = static_cast<unsigned int>(shader->getUniformLocation("zPosition"));
-	beziersUniform = static_cast<unsigned int>(shader->getUniformLocation("beziers"));
-	numBeziersUniform = static_cast<unsigned int>(shader->getUniformLocation("numBeziers"));
-	fillUniform = static_cast<unsigned int>(shader->getUniformLocation("fill"));
-	strokeUniform = static_cast<unsigned int>(shader->getUniformLocation("stroke"));
-	strokeRadiusUniform = static_cast<unsigned int>(shader->getUniformLocation("strokeRadius"));
+	// Load the shaders into the batch every path node is drawn within
+	const std::string vertShaderPath = mainApp->getAssetFolderPath() + "shaders/PathNode.vert";
+	const std::string fragShaderPath = mainApp->getAssetFolderPath() + "shaders/PathNode.frag";
+	batch = std::make_unique<PathBatch>(vertShaderPath, fragShaderPath);
 
-	// Get the attribute locations
-	posAttribute = static_cast<unsigned int>(shader->getAttributeLocation("pos"));
+	// Tessellated path nodes are drawn as flat colored triangles, curve filled path nodes through the stencil buffer
+	PathMesh::setup(mainApp->getAssetFolderPath() + "shaders/PathMesh.vert", mainApp->getAssetFolderPath() + "shaders/PathMesh.frag");
+	PathCurveMesh::setup(mainApp->getAssetFolderPath() + "shaders/PathCurveMesh.vert",
+		mainApp->getAssetFolderPath() + "shaders/PathCurveMesh.frag");
 }
 
 /**
  * Deletes shaders/cleans up
  */
 void PathNode::cleanup() {
-	shader.reset();
+	batch.reset();
+	PathMesh::cleanup();
+	PathCurveMesh::cleanup();
 }
 
 /**
@@ -76,17 +78,38 @@ void PathNode::updateBoundingBox() {
 		Collidable::boundingBox.bottomRight += strokeRadius;
 	}
 
-	const std::array<Vector2f, 4> verts = {
-		Collidable::boundingBox.bottomLeft(),
-		Collidable::boundingBox.topLeft,
-		Collidable::boundingBox.bottomRight,
-		Collidable::boundingBox.topRight()
-	};
+	// Render only reads the snapshot and may run while this node updates, the path and bounding box are copied when the next
+	// snapshot is taken
+	pathChanged = true;
+}
 
-	std::copy(reinterpret_cast<const float*>(&verts.front()), reinterpret_cast<const float*>(&verts.back()), vertexArray->vertices.data.begin());
-	
-	// OpenGL commands must be run on the main thread - add a task for it. 
-	mainApp->runTaskOnMainThread([&]() { vertexArray->vertices.updateBuffer(); });
+/**
+ * Binds the path & transform FSMs to this node so changes to them wake it, as either may be replaced after begin
+ */
+void PathNode::bindStateAnimatables() {
+	if (pathFSM.has_value()) pathFSM->setNode(this);
+	if (transformFSM.has_value()) transformFSM->setNode(this);
+}
+
+/**
+ * Gets the way the node is drawn, batched when the render mode isn't supported by the node
+ * @returns The way the node is drawn
+ */
+PathNode::RenderMode PathNode::getSupportedRenderMode() const {
+	// Inside strokes are clipped to the fill, which only the batch's per pixel tests can do
+	if (pathFSM.has_value() || skeletalAnimatable != nullptr || stroke == StrokeStyle::Inside) return RenderMode::Batched;
+	return renderMode == RenderMode::Tessellated || renderMode == RenderMode::Curves ? renderMode : RenderMode::Batched;
+}
+
+/**
+ * Converts a saved render mode, falling back to batched with a warning when the render mode is unknown
+ * @param mode The saved render mode
+ * @returns The render mode
+ */
+PathNode::RenderMode PathNode::toRenderMode(int mode) {
+	if (mode >= static_cast<int>(RenderMode::Batched) && mode <= static_cast<int>(RenderMode::Curves)) return static_cast<RenderMode>(mode);
+	console.warn("Unknown path node render mode " + std::to_string(mode) + ", drawing batched instead");
+	return RenderMode::Batched;
 }
 
 /**
@@ -95,25 +118,17 @@ void PathNode::updateBoundingBox() {
  * @param scene The scene the node has been added to
  */
 void PathNode::begin(const Scene& scene) {
-	Collidable::boundingBox = path.getBoundingBox();
-	
-	if (stroke == StrokeStyle::Outside || stroke == StrokeStyle::Both) {
-		Collidable::boundingBox.topLeft -= strokeRadius;
-		Collidable::boundingBox.bottomRight += strokeRadius;
-	}
-
-	const std::array<Vector2f, 4> verts = {
-		Collidable::boundingBox.bottomLeft(),
-		Collidable::boundingBox.topLeft,
-		Collidable::boundingBox.bottomRight,
-		Collidable::boundingBox.topRight()
-	};
-
-	const std::array<unsigned int, 6> indices = {0, 1, 2, 1, 3, 2};
-
-	OpenGL::BufferUsage usage = (pathFSM.has_value() || skeletalAnimatable != nullptr) ? OpenGL::BufferUsage::Dynamic : OpenGL::BufferUsage::Static;
-	vertexArray = std::make_unique<OpenGL::VertexArray<Vector2f, 2>>(verts, indices, usage);
-	vertexArray->enableAttributePointer({posAttribute});
+	bindStateAnimatables();
+
+	updateBoundingBox();
+	batch->upload(bezierRange, path.beziers, stroke == StrokeStyle::Neither ? 0.0f : strokeRadius);
+	renderSnapshot.boundingBox = Collidable::boundingBox;
+	renderSnapshot.strokeRadius = strokeRadius;
+	renderSnapshot.stroke = stroke;
+	renderSnapshot.fill = fill;
+	renderSnapshot.renderMode = RenderMode::Batched;
+	pathChanged = false;
+	begun = true;
 }
 
 /**
@@ -123,6 +138,8 @@ void PathNode::begin(const Scene& scene) {
  * @param deltaTime The duration of the last frame in microseconds
  */
 void PathNode::preUpdate(size_t threadNum, const Scene& scene, float deltaTime) {
+	bindStateAnimatables();
+
 	// Call transformable update
 	Transformable::updateTransform(deltaTime);
 
@@ -152,16 +169,23 @@ void PathNode::preUpdate(size_t threadNum, const Scene& scene, float deltaTime)
 		// Loop through the beziers and transform the beziers into the path
 		for (size_t i = 0; i < path.beziers.size(); i++) {
 			path.beziers[i] = CubicBezier{
-				skeletalAnimatable->transform(basePath.value().beziers[i].start, skeletalWeights.value().at(i).startWeight, deltaTime),
-				skeletalAnimatable->transform(basePath.value().beziers[i].controlPoint1, skeletalWeights.value().at(i).controlPoint1Weight, deltaTime),
-				skeletalAnimatable->transform(basePath.value().beziers[i].controlPoint2, skeletalWeights.value().at(i).controlPoint2Weight, deltaTime),
-				skeletalAnimatable->transform(basePath.value().beziers[i].end, skeletalWeights.value().at(i).endWeight, deltaTime)
+				skeletalAnimatable->transform(basePath.value().beziers[i].start, skeletalWeights.value().at(i).startWeight),
+				skeletalAnimatable->transform(basePath.value().beziers[i].controlPoint1, skeletalWeights.value().at(i).controlPoint1Weight),
+				skeletalAnimatable->transform(basePath.value().beziers[i].controlPoint2, skeletalWeights.value().at(i).controlPoint2Weight),
+				skeletalAnimatable->transform(basePath.value().beziers[i].end, skeletalWeights.value().at(i).endWeight)
 			};
 		}
 
 		// Update the bounding box
 		updateBoundingBox();
 	}
+
+	// Animations off the screen are run at the scene's reduced level of detail, the skipped time is caught up on the next update
+	if (!isDormant()) {
+		const Rect worldBounds = getFullTransform().transform(Collidable::boundingBox).getBoundingBox();
+		float interval = scene.getUpdateLODInterval(worldBounds);
+		if (interval > getUpdateInterval()) scheduleNextUpdate(interval, worldBounds);
+	}
 }
 
 /**
@@ -169,32 +193,122 @@ void PathNode::preUpdate(size_t threadNum, const Scene& scene, float deltaTime)
  * @param camera The camera to render with
  */
 void PathNode::render(const Camera& camera, float deltaTime) const {
-	// There is no vertex array setup - nothing to render
-	if (vertexArray == nullptr) return;
+	if (!begun || batch == nullptr) return;
+
+	// Skip nodes entirely off the screen, the camera transforms to normalized device coordinates
+	const Transform fullTransform(camera * renderSnapshot.transform);
+	const Rect screenBounds = fullTransform.transform(renderSnapshot.boundingBox).getBoundingBox();
+	if (screenBounds.topLeft.x > 1.0f || screenBounds.bottomRight.x < -1.0f || screenBounds.topLeft.y < -1.0f ||
+		screenBounds.bottomRight.y > 1.0f) return;
+
+	// Tessellated & curve filled nodes are drawn straight away, tessellating again at the current zoom when needed
+	const RenderMode mode = renderSnapshot.renderMode;
+	if (mode != RenderMode::Batched) {
+		const bool strokeOverFill = renderSnapshot.stroke == StrokeStyle::Both;
+		if (mode == RenderMode::Curves && renderSnapshot.fill) {
+			if (curveMesh == nullptr) curveMesh = std::make_unique<PathCurveMesh>(renderSnapshot.path);
+			if (!strokeOverFill) curveMesh->render(fullTransform, renderSnapshot.zPosition, renderSnapshot.color);
+		}
 
-	// Use the shader & provide uniforms
-	shader->useProgram();
-	shader->uniform(cameraUniform, camera);
-	shader->uniform(localUniform, getFullTransform()); 
-	shader->uniform(vertexColorUniform, color);
-	shader->uniform(strokeColorUniform, strokeColor);
-	shader->uniform(zPositionUniform, zPosition);
-	shader->uniform(fillUniform, fill ? 1 : 0);
-	shader->uniform(strokeUniform, static_cast<int>(stroke));
-	shader->uniform(strokeRadiusUniform, strokeRadius);
+		// Normalized device coordinates span the framebuffer twice over, the rows of the transform give each axis' scale
+		if (mode == RenderMode::Tessellated || renderSnapshot.stroke != StrokeStyle::Neither) {
+			const Vector2ui framebufferSize = mainApp->getWindow().getFramebufferSize();
+			const float pixelsPerUnit = std::max(
+				std::hypot(fullTransform.data[0], fullTransform.data[1]) * static_cast<float>(framebufferSize.x),
+				std::hypot(fullTransform.data[3], fullTransform.data[4]) * static_cast<float>(framebufferSize.y)) / 2.0f;
+			if (mesh == nullptr) mesh = std::make_unique<PathMesh>();
+			if (mesh->needsTessellation(pixelsPerUnit)) mesh->tessellate(renderSnapshot.path, mode == RenderMode::Tessellated && renderSnapshot.fill,
+				renderSnapshot.stroke == StrokeStyle::Neither ? 0.0f : renderSnapshot.strokeRadius, pixelsPerUnit);
+			mesh->render(fullTransform, renderSnapshot.zPosition, renderSnapshot.color, renderSnapshot.strokeColor, strokeOverFill);
+		}
 
-	shader->uniform(beziersUniform, reinterpret_cast<const Vector2f*>(path.beziers.data()), path.beziers.size() * 4); 
-	shader->uniform(numBeziersUniform, static_cast<int>(path.beziers.size()));
+		// The fill is drawn after a stroke covering it, so depth testing leaves the stroke in front
+		if (curveMesh != nullptr && mode == RenderMode::Curves && renderSnapshot.fill && strokeOverFill)
+			curveMesh->render(fullTransform, renderSnapshot.zPosition, renderSnapshot.color);
+		return;
+	}
 
-	// Draw, fragment shaders will do the rest of the work for us
-	vertexArray->draw();
+	// Drawn from the snapshot with every other path node once all nodes have rendered, the live state may be mid update
+	batch->add(renderSnapshot.transform, renderSnapshot.boundingBox, bezierRange, renderSnapshot.color,
+		renderSnapshot.strokeColor, renderSnapshot.zPosition, renderSnapshot.strokeRadius, renderSnapshot.fill,
+		static_cast<int>(renderSnapshot.stroke));
 }
 
 /**
  * Called when the node is removed from the scene, guaranteed to be called from the main thread
  */
 void PathNode::end(const Scene& scene) {
-	vertexArray.reset();
+	begun = false;
+	if (batch != nullptr) batch->release(bezierRange);
+	mesh.reset();
+	curveMesh.reset();
+}
+
+/**
+ * Gets the skeletal animatable when set, so the skeleton is recalculated before this node is transformed by it
+ * @returns The nodes this node depends on
+ */
+std::vector<Node*> PathNode::getUpdateDependencies() const {
+	if (skeletalAnimatable == nullptr) return {};
+	return {skeletalAnimatable.get()};
+}
+
+/**
+ * Checks whether or not the node has nothing to animate, the node sleeps until an FSM or its skeletal animatable changes.
+ * Render state such as the transform and colors is snapshotted directly and never requires the node to be awake.
+ * @returns Whether or not no FSM or skeletal animatable is transitioning between states
+ */
+bool PathNode::isDormant() const {
+	if (transformFSM.has_value() && transformFSM->isTransitioning()) return false;
+	if (pathFSM.has_value() && pathFSM->isTransitioning()) return false;
+	return skeletalAnimatable == nullptr || !skeletalAnimatable->isTransitioning();
+}
+
+/**
+ * Copies the transform, bounding box, colors and other render state into the render snapshot & uploads the path when it has
+ * changed, guaranteed to be called from the main thread while no updates are running.
+ */
+void PathNode::takeRenderSnapshot() {
+	bindStateAnimatables();
+
+	// The beziers are binned into tiles with the stroke around them, so the path is uploaded again when the stroke changes
+	if (begun && (stroke != renderSnapshot.stroke || strokeRadius != renderSnapshot.strokeRadius)) updateBoundingBox();
+
+	// Nodes which aren't batched are tessellated from a copy of the path, taken when the path changes or the node stops batching
+	const RenderMode mode = getSupportedRenderMode();
+	const bool copyPath = begun && mode != RenderMode::Batched && (pathChanged || renderSnapshot.renderMode == RenderMode::Batched);
+	if (mesh != nullptr && (copyPath || fill != renderSnapshot.fill || mode != renderSnapshot.renderMode)) mesh->invalidate();
+	if (copyPath) {
+		renderSnapshot.path = path;
+		curveMesh.reset();
+	}
+
+	Transform fullTransform = getFullTransform();
+	renderSnapshot.previousTransform = renderSnapshotTaken ? renderSnapshot.currentTransform : fullTransform;
+	renderSnapshot.currentTransform = fullTransform;
+	renderSnapshot.transform = fullTransform;
+	renderSnapshotTaken = true;
+	renderSnapshot.color = color;
+	renderSnapshot.strokeColor = strokeColor;
+	renderSnapshot.zPosition = zPosition;
+	renderSnapshot.strokeRadius = strokeRadius;
+	renderSnapshot.fill = fill;
+	renderSnapshot.stroke = stroke;
+	renderSnapshot.renderMode = mode;
+
+	// Only upload the path & copy the bounding box when it has changed, static paths are never uploaded again
+	if (!pathChanged || !begun) return;
+	batch->upload(bezierRange, path.beziers, stroke == StrokeStyle::Neither ? 0.0f : strokeRadius);
+	renderSnapshot.boundingBox = Collidable::boundingBox;
+	pathChanged = false;
+}
+
+/**
+ * Blends the transforms of the previous and current render snapshots, guaranteed to be called from the main thread prior to rendering
+ * @param alpha How far between the previous (0) and current (1) snapshot the rendered frame lies
+ */
+void PathNode::interpolateRenderSnapshot(float alpha) {
+	renderSnapshot.transform = renderSnapshot.previousTransform * (1.0f - alpha) + renderSnapshot.currentTransform * alpha;
 }
 
 /**
@@ -216,6 +330,7 @@ PathNode::PathNode(const JSON& json) : Node(json.value("preUpdateTime", 100.0f),
 	if (json.contains("fill")) fill = json["fill"].get<bool>();
 	if (json.contains("stroke")) stroke = static_cast<StrokeStyle>(json["stroke"].get<int>());
 	if (json.contains("strokeRadius")) strokeRadius = json["strokeRadius"].get<float>();
+	if (json.contains("renderMode")) renderMode = toRenderMode(json["renderMode"].get<int>());
 	if (json.contains("color")) color = json["color"].get<Color>();
 	if (json.contains("strokeColor")) strokeColor = json["strokeColor"].get<Color>();
 	if (json.contains("path")) path = json["path"].get<Path>();
@@ -228,6 +343,60 @@ PathNode::PathNode(const JSON& json) : Node(json.value("preUpdateTime", 100.0f),
 	}
 }
 
+/**
+ * Creates a path node from a binary scene save state, copying the beziers out of the scene file in single blocks
+ * @param reader The reader positioned at the node's record
+ */
+PathNode::PathNode(BinarySceneReader& reader) : PathNode(reader, reader.read<std::array<float, 2>>()) {
+	// Empty Body
+}
+
+/**
+ * Creates a path node from a binary scene, once the node's average update times have been read
+ * @param reader The reader positioned after the update times
+ * @param updateTimes The average pre update and update times
+ */
+PathNode::PathNode(BinarySceneReader& reader, std::array<float, 2> updateTimes) : Node(updateTimes[0], updateTimes[1]) {
+	// Load Basic Properties
+	name = reader.readString();
+	readBinary(reader, Transformable::transform);
+	zPosition = reader.read<float>();
+	fill = reader.read<uint8_t>() != 0;
+	stroke = static_cast<StrokeStyle>(reader.read<int32_t>());
+	strokeRadius = reader.read<float>();
+	renderMode = toRenderMode(reader.read<int32_t>());
+	color = reader.read<Color>();
+	strokeColor = reader.read<Color>();
+	readBinary(reader, path);
+
+	// Load FSMs
+	if (reader.read<uint8_t>() != 0) transformFSM = StateAnimatable<Transform>(reader);
+	if (reader.read<uint8_t>() != 0) pathFSM = StateAnimatable<Path>(reader);
+}
+
+/**
+ * Writes the node to a binary scene save state
+ * @param writer The writer of the node's record
+ */
+void PathNode::write(BinarySceneWriter& writer) const {
+	writer.write(std::array<float, 2>{preUpdateTime, updateTime});
+	writer.writeString(name);
+	writeBinary(writer, Transformable::transform);
+	writer.write(zPosition);
+	writer.write(static_cast<uint8_t>(fill));
+	writer.write(static_cast<int32_t>(stroke));
+	writer.write(strokeRadius);
+	writer.write(static_cast<int32_t>(renderMode));
+	writer.write(color);
+	writer.write(strokeColor);
+	writeBinary(writer, path);
+
+	writer.write(static_cast<uint8_t>(transformFSM.has_value()));
+	if (transformFSM.has_value()) transformFSM->write(writer);
+	writer.write(static_cast<uint8_t>(pathFSM.has_value()));
+	if (pathFSM.has_value()) pathFSM->write(writer);
+}
+
 /**
  * Creates a path node given the path to use
  * @param path The path to use
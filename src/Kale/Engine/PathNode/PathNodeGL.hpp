@@ -24,9 +24,11 @@
 #include <Kale/Engine/SkeletalAnimatable/SkeletalAnimatable.hpp>
 #include <Kale/Engine/Collidable/Collidable.hpp>
 #include <Kale/Engine/Transformable/Transformable.hpp>
+#include <Kale/Engine/PathBatch/PathBatch.hpp>
+#include <Kale/Engine/PathCurveMesh/PathCurveMesh.hpp>
+#include <Kale/Engine/PathMesh/PathMesh.hpp>
 #include <Kale/Math/Path/Path.hpp>
-#include <Kale/OpenGL/VertexArray/VertexArray.hpp>
-#include <Kale/OpenGL/Shader/Shader.hpp>
+#include <Kale/Math/Rect/Rect.hpp>
 
 #include <memory>
 #include <optional>
@@ -58,6 +60,18 @@ namespace Kale {
 			Neither = 0, Both = 1, Inside = 2, Outside = 3
 		};
 
+		/**
+		 * Ways of drawing a path. Path nodes with a path FSM, a skeletal animatable or an inside stroke are always batched.
+		 * Batched - Drawn with every other batched path node, testing the beziers near each pixel. Suits paths which change often.
+		 * Tessellated - Drawn as triangles tessellated on the CPU, tessellated again when the path changes or the camera zooms in
+		 * or out by a factor of two. The cheapest to draw for paths which rarely change.
+		 * Curves - Filled with triangles evaluating the implicit form of each bezier per pixel, staying sharp at any zoom without
+		 * tessellating again. The stroke is tessellated.
+		 */
+		enum class RenderMode {
+			Batched = 0, Tessellated = 1, Curves = 2
+		};
+
 		/**
 		 * Contains the weights required for skinning/skeletal rigging a single cubic bezier curve
 		 */
@@ -87,30 +101,115 @@ namespace Kale {
 	private:
 
 		/**
-		 * The vertex array used for rendering
+		 * The state read by render, copied from the live node state by takeRenderSnapshot
+		 */
+		struct RenderSnapshot {
+
+			/**
+			 * The full transform of the node to render with
+			 */
+			Transform transform;
+
+			/**
+			 * The full transform of the node when the snapshot was taken
+			 */
+			Transform currentTransform;
+
+			/**
+			 * The full transform of the node when the prior snapshot was taken
+			 */
+			Transform previousTransform;
+
+			/**
+			 * The local bounding box of the path, including the stroke
+			 */
+			Rect boundingBox;
+
+			/**
+			 * The fill color of the node
+			 */
+			Color color;
+
+			/**
+			 * The stroke color of the node
+			 */
+			Color strokeColor;
+
+			/**
+			 * The z position of the node
+			 */
+			float zPosition;
+
+			/**
+			 * The radius of the stroke
+			 */
+			float strokeRadius;
+
+			/**
+			 * Whether or not to fill the path
+			 */
+			bool fill;
+
+			/**
+			 * The style of the stroke
+			 */
+			StrokeStyle stroke;
+
+			/**
+			 * The way the path is drawn, batched when the render mode isn't supported by the node
+			 */
+			RenderMode renderMode;
+
+			/**
+			 * The path to tessellate when not batched, only copied when the path changes while the node isn't batched
+			 */
+			Path path;
+		};
+
+		/**
+		 * The render state as of the last snapshot
 		 */
-		std::unique_ptr<OpenGL::VertexArray<Vector2f, 2>> vertexArray;
+		RenderSnapshot renderSnapshot;
 
 		/**
-		 * The path being rendered
+		 * The node's range of the batch's bezier storage, uploaded only when the path changes
 		 */
-		Path path;
+		PathBatch::BezierRange bezierRange;
 
 		/**
-		 * The shader used for rendering
+		 * The triangles tessellated from the path when not batched, created & tessellated again when drawn as the path or zoom changes
 		 */
-		static inline std::unique_ptr<const OpenGL::Shader> shader = nullptr;
+		mutable std::unique_ptr<PathMesh> mesh;
 
 		/**
-		 * The location of the uniform within the shader for rendering this node
+		 * The triangles filling the path when drawing curves, created again when drawn after the path changes
 		 */
-		inline static unsigned int cameraUniform, localUniform, vertexColorUniform, zPositionUniform,
-			beziersUniform, numBeziersUniform, strokeUniform, fillUniform, strokeRadiusUniform, strokeColorUniform;
-		
+		mutable std::unique_ptr<PathCurveMesh> curveMesh;
+
 		/**
-		 * The location of the attribute within the shader for rendering this node
+		 * Whether or not the path and bounding box have changed since the last snapshot
 		 */
-		inline static unsigned int posAttribute;
+		bool pathChanged = false;
+
+		/**
+		 * Whether or not a render snapshot has been taken yet
+		 */
+		bool renderSnapshotTaken = false;
+
+		/**
+		 * Whether or not the node has begun and not yet ended, only then is it rendered
+		 */
+		bool begun = false;
+
+		/**
+		 * The path being rendered
+		 */
+		Path path;
+
+		/**
+		 * The batch every path node is drawn within, path nodes are drawn together once every node has rendered
+		 */
+		static inline std::unique_ptr<PathBatch> batch = nullptr;
 		
 		/**
 		 * Creates and compiles shaders
@@ -127,6 +226,31 @@ namespace Kale {
 		 */
 		void updateBoundingBox();
 
+		/**
+		 * Binds the path & transform FSMs to this node so changes to them wake it, as either may be replaced after begin
+		 */
+		void bindStateAnimatables();
+
+		/**
+		 * Gets the way the node is drawn, batched when the render mode isn't supported by the node
+		 * @returns The way the node is drawn
+		 */
+		RenderMode getSupportedRenderMode() const;
+
+		/**
+		 * Converts a saved render mode, falling back to batched with a warning when the render mode is unknown
+		 * @param mode The saved render mode
+		 * @returns The render mode
+		 */
+		static RenderMode toRenderMode(int mode);
+
+		/**
+		 * Creates a path node from a binary scene, once the node's average update times have been read
+		 * @param reader The reader positioned after the update times
+		 * @param updateTimes The average pre update and update times
+		 */
+		PathNode(BinarySceneReader& reader, std::array<float, 2> updateTimes);
+
 		friend class Application;
 
 	protected:
@@ -147,7 +271,7 @@ namespace Kale {
 		virtual void preUpdate(size_t threadNum, const Scene& scene, float deltaTime) override;
 
 		/**
-		 * Renders the node
+		 * Adds the node to the batch of path nodes drawn once every node has rendered, unless it is off the screen
 		 * @param camera The camera to render with
 		 */
 		virtual void render(const Camera& camera, float deltaTime) const override;
@@ -157,16 +281,43 @@ namespace Kale {
 		 */
 		virtual void end(const Scene& scene) override;
 
+		/**
+		 * Gets the skeletal animatable when set, so the skeleton is recalculated before this node is transformed by it
+		 * @returns The nodes this node depends on
+		 */
+		virtual std::vector<Node*> getUpdateDependencies() const override;
+
+		/**
+		 * Checks whether or not the node has nothing to animate, the node sleeps until an FSM or its skeletal animatable changes.
+		 * Render state such as the transform and colors is snapshotted directly and never requires the node to be awake.
+		 * @returns Whether or not no FSM or skeletal animatable is transitioning between states
+		 */
+		virtual bool isDormant() const override;
+
+		/**
+		 * Copies the transform, bounding box, colors and other render state into the render snapshot & uploads the path when
+		 * it has changed, guaranteed to be called from the main thread while no updates are running.
+		 */
+		virtual void takeRenderSnapshot() override;
+
+		/**
+		 * Blends the transforms of the previous and current render snapshots, guaranteed to be called from the main thread prior to rendering
+		 * @param alpha How far between the previous (0) and current (1) snapshot the rendered frame lies
+		 */
+		virtual void interpolateRenderSnapshot(float alpha) override;
+
 	public:
 
 		/**
 		 * The FSM used for path states. Path nodes support FSM based animations, to use the FSM simply set the value of this optional and fill
-		 * the map. Access to the FSM must be externally synchronized if done from multiple threads.
+		 * the map. Access to the FSM must be externally synchronized if done from multiple threads. If the FSM is set after the node
+		 * is added to the scene, the node must be woken via Node::wake.
 		 */
 		std::optional<StateAnimatable<Path>> pathFSM;
 
 		/**
 		 * A skeletal animatable to use for animating this path node. Both pathFSM and skeletalAnimatable cannot be set at the same time.
+		 * The skeletal animatable must be added to the scene and set prior to this node being added, as it is recalculated by its own pre update.
 		 */
 		std::shared_ptr<SkeletalAnimatable> skeletalAnimatable;
 
@@ -203,6 +354,11 @@ namespace Kale {
 		 */
 		float strokeRadius = 20.0f;
 
+		/**
+		 * The way to draw the path
+		 */
+		RenderMode renderMode = RenderMode::Batched;
+
 		/**
 		 * The color of this path node
 		 */
@@ -224,6 +380,18 @@ namespace Kale {
 		 */
 		PathNode(const JSON& json);
 
+		/**
+		 * Creates a path node from a binary scene save state, copying the beziers out of the scene file in single blocks
+		 * @param reader The reader positioned at the node's record
+		 */
+		PathNode(BinarySceneReader& reader);
+
+		/**
+		 * Writes the node to a binary scene save state
+		 * @param writer The writer of the node's record
+		 */
+		void write(BinarySceneWriter& writer) const;
+
 		/**
 		 * Creates a path node given the path to use
 		 * @param path The path to use
@@ -48,7 +48,7 @@ Skeleton::Skeleton(const std::vector<Bone>& bones) : bones(bones) {
  * Creates an empty skeletal animatable
  */
 SkeletalAnimatable::SkeletalAnimatable() {
-	// Empty Body
+	setNode(this);
 }
 
 /**
@@ -56,7 +56,7 @@ SkeletalAnimatable::SkeletalAnimatable() {
  * @param base The base skeleton all transformed vertices are rigged by
  */
 SkeletalAnimatable::SkeletalAnimatable(const Skeleton& base) : base(base) {
-	// Empty Body
+	setNode(this);
 }
 
 /**
@@ -65,6 +65,7 @@ SkeletalAnimatable::SkeletalAnimatable(const Skeleton& base) : base(base) {
  */
 void SkeletalAnimatable::setBase(const Skeleton& skeleton) {
 	base = skeleton;
+	wake();
 }
 
 /**
@@ -72,15 +73,8 @@ void SkeletalAnimatable::setBase(const Skeleton& skeleton) {
  * @param deltaTime The duration of the last frame in microseconds
  */
 void SkeletalAnimatable::recalculateSkeleton(float deltaTime) {
-	// Everything below is thread sensitive and modifies data accessed from other threads. We need mutual access to it
-	std::lock_guard lock(mutex);
-
-	// If the skeleton has already been recalculated, we don't need to recalculate.
-	if (skeletonRecalculated) return;
-
-	// Update the states and retrieve the composition. Also flag the skeleton as recalculated
+	// Only this node's pre update recalculates, dependents are scheduled after it so no locking is needed
 	updateState(deltaTime);
-	skeletonRecalculated = true;
 	std::vector<std::pair<int, float>> composition = getStateComposition<int>();
 
 	// Resize the skeleton if it isn't already at the correct size
@@ -106,65 +100,84 @@ void SkeletalAnimatable::recalculateSkeleton(float deltaTime) {
 }
 
 /**
- * Called on update, perfect place to do any physics updating, game logic, etc
+ * Recalculates the skeleton, the scene runs this before the pre update of any node depending on this skeletal animatable
  * @param threadNum the index of the thread this update is called on
  * @param scene The scene being updated to
  * @param deltaTime The duration of the last frame in microseconds
  */
-void SkeletalAnimatable::update(size_t threadNum, const Scene& scene, float deltaTime) {
-	skeletonRecalculated = false;
+void SkeletalAnimatable::preUpdate(size_t threadNum, const Scene& scene, float deltaTime) {
+	recalculateSkeleton(deltaTime);
 }
 
 /**
- * Called prior to update, perfect place to do things such as updating the bounding box, etc
- * @param threadNum the index of the thread this update is called on
- * @param scene The scene being updated to
- * @param deltaTime The duration of the last frame in microseconds
+ * Checks whether or not the skeleton is settled, the skeletal animatable sleeps until its states or animation change
+ * @returns Whether or not the skeleton isn't transitioning between states
  */
-void SkeletalAnimatable::preUpdate(size_t threadNum, const Scene& scene, float deltaTime) {
-	recalculateSkeleton(deltaTime);
+bool SkeletalAnimatable::isDormant() const {
+	return !isTransitioning();
 }
 
 /**
- * Thread-Safe method to get the current skeleton, must be called during a pre-update and cannot be called during the update.
- * If you need access to the skeleton for transformation/skinning during an update, use getSkeletonNoRecalc().
- * @param deltaTime The duration of the last frame in microseconds
+ * Gets the current skeleton. Nodes reading the skeleton during their pre update must return this skeletal animatable from
+ * Node::getUpdateDependencies, so the skeleton is recalculated before they run.
  * @returns The skeleton for this frame
  */
-const std::vector<Transform>& SkeletalAnimatable::getSkeleton(float deltaTime) {
-	recalculateSkeleton(deltaTime);
+const std::vector<Transform>& SkeletalAnimatable::getSkeleton() const {
 	return skeleton;
 }
 
 /**
- * Thread-Safe method to get the current skeleton, the skeleton will not be recalculated even if it is flagged as out of date.
- * This method should only be called after pre-updates, otherwise it may not be updated, or worse may update on another thread while
- * given.
- * @returns The skeleton as it is
+ * Transforms a single vertex given its weights. Nodes transforming during their pre update must return this skeletal animatable
+ * from Node::getUpdateDependencies, so the skeleton is recalculated before they run. Vertices are returned untransformed until
+ * the skeleton is first calculated.
+ * @param vert The vertex to transform
+ * @param weights The weights of the vertex, 4 pairs of the index of the bone along with the significance. Must add up to 1, set the
+ * index of the bone to -1 if it is unassigned.
+ * @returns The transformed vertex
+ */
+Vector2f SkeletalAnimatable::transform(Vector2f vert, const std::array<std::pair<int, float>, 4>& weights) const {
+	if (skeleton.empty()) return vert;
+	return Skeleton::transform(skeleton, vert, weights);
+}
+
+/**
+ * Gets the current skeleton, the skeleton is no longer recalculated on request so the delta time is ignored
+ * @deprecated Use getSkeleton() and return this skeletal animatable from Node::getUpdateDependencies
+ * @param deltaTime Ignored
+ * @returns The skeleton for this frame
+ */
+const std::vector<Transform>& SkeletalAnimatable::getSkeleton(float deltaTime) const {
+	return skeleton;
+}
+
+/**
+ * Gets the current skeleton
+ * @deprecated Use getSkeleton()
+ * @returns The skeleton for this frame
  */
 const std::vector<Transform>& SkeletalAnimatable::getSkeletonNoRecalc() const {
 	return skeleton;
 }
 
 /**
- * Transforms a single vertex given its weights
+ * Transforms a single vertex given its weights, the skeleton is no longer recalculated on request so the delta time is ignored
+ * @deprecated Use transform(vert, weights) and return this skeletal animatable from Node::getUpdateDependencies
  * @param vert The vertex to transform
- * @param weights The weights of the vertex, 4 pairs of the index of the bone along with the significance. Must add up to 1, set the
- * index of the bone to -1 if it is unassigned.
+ * @param weights The weights of the vertex, please see SkeletalAnimatable::transform for documentation
+ * @param deltaTime Ignored
  * @returns The transformed vertex
  */
-Vector2f SkeletalAnimatable::transform(Vector2f vert, const std::array<std::pair<int, float>, 4>& weights, float deltaTime) {
-	recalculateSkeleton(deltaTime);
-	return Skeleton::transform(skeleton, vert, weights);
+Vector2f SkeletalAnimatable::transform(Vector2f vert, const std::array<std::pair<int, float>, 4>& weights, float deltaTime) const {
+	return transform(vert, weights);
 }
 
 /**
  * Transforms a single vertex given its weights
+ * @deprecated Use transform(vert, weights)
  * @param vert The vertex to transform
- * @param weights The weights of the vertex, 4 pairs of the index of the bone along with the significance. Must add up to 1, set the
- * index of the bone to -1 if it is unassigned.
+ * @param weights The weights of the vertex, please see SkeletalAnimatable::transform for documentation
  * @returns The transformed vertex
  */
 Vector2f SkeletalAnimatable::transformNoRecalc(Vector2f vert, const std::array<std::pair<int, float>, 4>& weights) const {
-	return Skeleton::transform(skeleton, vert, weights);
+	return transform(vert, weights);
 }
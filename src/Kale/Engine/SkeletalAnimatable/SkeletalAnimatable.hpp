@@ -23,7 +23,6 @@
 #include <vector>
 #include <tuple>
 #include <array>
-#include <mutex>
 #include <algorithm>
 
 namespace Kale {
@@ -152,17 +151,6 @@ namespace Kale {
 		 */
 		Skeleton base;
 
-		/**
-		 * Whether or not the skeleton has been recalculated for this frame. This is set to true whenever the skeleton is recalculated
-		 * and set to false again every update.
-		 */
-		bool skeletonRecalculated;
-
-		/**
-		 * Mutex used for ensuring safe access to skeleton updates
-		 */
-		std::mutex mutex;
-
 		/**
 		 * Recalculates the skeleton based on the current state composition
 		 * @param deltaTime The duration of the last frame in microseconds
@@ -172,20 +160,18 @@ namespace Kale {
 	protected:
 
 		/**
-		 * Called on update, perfect place to do any physics updating, game logic, etc
+		 * Recalculates the skeleton, the scene runs this before the pre update of any node depending on this skeletal animatable
 		 * @param threadNum the index of the thread this update is called on
 		 * @param scene The scene being updated to
 		 * @param deltaTime The duration of the last frame in microseconds
 		 */
-		void update(size_t threadNum, const Scene& scene, float deltaTime) override;
+		void preUpdate(size_t threadNum, const Scene& scene, float deltaTime) override;
 
 		/**
-		 * Called prior to update, perfect place to do things such as updating the bounding box, etc
-		 * @param threadNum the index of the thread this update is called on
-		 * @param scene The scene being updated to
-		 * @param deltaTime The duration of the last frame in microseconds
+		 * Checks whether or not the skeleton is settled, the skeletal animatable sleeps until its states or animation change
+		 * @returns Whether or not the skeleton isn't transitioning between states
 		 */
-		void preUpdate(size_t threadNum, const Scene& scene, float deltaTime) override;
+		bool isDormant() const override;
 
 	public:
 
@@ -207,39 +193,59 @@ namespace Kale {
 		void setBase(const Skeleton& skeleton);
 
 		/**
-		 * Thread-Safe method to get the current skeleton, must be called during a pre-update and cannot be called during the update.
-		 * If you need access to the skeleton for transformation/skinning during an update, use getSkeletonNoRecalc().
-		 * @param deltaTime The duration of the last frame in microseconds
+		 * Gets the current skeleton. Nodes reading the skeleton during their pre update must return this skeletal animatable from
+		 * Node::getUpdateDependencies, so the skeleton is recalculated before they run.
+		 * @returns The skeleton for this frame
+		 */
+		const std::vector<Transform>& getSkeleton() const;
+
+		/**
+		 * Transforms a single vertex given its weights. Nodes transforming during their pre update must return this skeletal animatable
+		 * from Node::getUpdateDependencies, so the skeleton is recalculated before they run. Vertices are returned untransformed until
+		 * the skeleton is first calculated.
+		 * @param vert The vertex to transform
+		 * @param weights The weights of the vertex, 4 pairs of the index of the bone along with the significance. Must add up to 1, set the
+		 * index of the bone to -1 if it is unassigned.
+		 * @returns The transformed vertex
+		 */
+		Vector2f transform(Vector2f vert, const std::array<std::pair<int, float>, 4>& weights) const;
+
+		/**
+		 * Gets the current skeleton, the skeleton is no longer recalculated on request so the delta time is ignored
+		 * @deprecated Use getSkeleton() and return this skeletal animatable from Node::getUpdateDependencies
+		 * @param deltaTime Ignored
 		 * @returns The skeleton for this frame
 		 */
-		const std::vector<Transform>& getSkeleton(float deltaTime);
+		[[deprecated("Use getSkeleton() and depend on the skeletal animatable")]]
+		const std::vector<Transform>& getSkeleton(float deltaTime) const;
 
 		/**
-		 * Thread-Safe method to get the current skeleton, the skeleton will not be recalculated even if it is flagged as out of date.
-		 * This method should only be called after pre-updates, otherwise it may not be updated, or worse may update on another thread while
-		 * given.
-		 * @returns The skeleton as it is
+		 * Gets the current skeleton
+		 * @deprecated Use getSkeleton()
+		 * @returns The skeleton for this frame
 		 */
+		[[deprecated("Use getSkeleton()")]]
 		const std::vector<Transform>& getSkeletonNoRecalc() const;
 
 		/**
-		 * Transforms a single vertex given its weights, cannot be called during the update.
+		 * Transforms a single vertex given its weights, the skeleton is no longer recalculated on request so the delta time is ignored
+		 * @deprecated Use transform(vert, weights) and return this skeletal animatable from Node::getUpdateDependencies
 		 * @param vert The vertex to transform
-		 * @param weights The weights of the vertex, 4 pairs of the index of the bone along with the significance. Must add up to 1, set the
-		 * index of the bone to -1 if it is unassigned.
-		 * @param deltaTime The duration of the last frame in microseconds
+		 * @param weights The weights of the vertex, please see SkeletalAnimatable::transform for documentation
+		 * @param deltaTime Ignored
 		 * @returns The transformed vertex
 		 */
-		Vector2f transform(Vector2f vert, const std::array<std::pair<int, float>, 4>& weights, float deltaTime);
+		[[deprecated("Use transform(vert, weights) and depend on the skeletal animatable")]]
+		Vector2f transform(Vector2f vert, const std::array<std::pair<int, float>, 4>& weights, float deltaTime) const;
 
 		/**
-		 * Transforms a single vertex given its weights. This method should only be called after pre-updates, otherwise it may
-		 * not be updated, or worse may update on another thread while given.
+		 * Transforms a single vertex given its weights
+		 * @deprecated Use transform(vert, weights)
 		 * @param vert The vertex to transform
-		 * @param weights The weights of the vertex, 4 pairs of the index of the bone along with the significance. Must add up to 1, set the
-		 * index of the bone to -1 if it is unassigned.
+		 * @param weights The weights of the vertex, please see SkeletalAnimatable::transform for documentation
 		 * @returns The transformed vertex
 		 */
+		[[deprecated("Use transform(vert, weights)")]]
 		Vector2f transformNoRecalc(Vector2f vert, const std::array<std::pair<int, float>, 4>& weights) const;
 
 	};
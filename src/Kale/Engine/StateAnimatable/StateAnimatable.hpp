@@ -15,12 +15,14 @@
 
 #include <Kale/Core/Logger/Logger.hpp>
 #include <Kale/Engine/Node/Node.hpp>
+#include <Kale/Core/BinaryScene/BinaryScene.hpp>
 
 #include <unordered_map>
 #include <vector>
 #include <utility>
 #include <mutex>
 #include <memory>
+#include <cstdint>
 
 #include <nlohmann/json.hpp>
 
@@ -42,27 +44,27 @@ namespace Kale {
 		/**
 		 * The path state currently being rendered
 		 */
-		int state;
+		int state = 0;
 
 		/**
 		 * The state currently being transitioned to
 		 */
-		int transitionState;
+		int transitionState = 0;
 
 		/**
 		 * Whether or not the path is morphing between two paths
 		 */
-		bool transitioning;
+		bool transitioning = false;
 
 		/**
 		 * The transition time between the two paths
 		 */
-		float transitionTime;
+		float transitionTime = 0.0f;
 
 		/**
 		 * The duration in seconds for the transition to last
 		 */
-		float transitionDuration;
+		float transitionDuration = 0.0f;
 
 		/**
 		 * Contains structures for each state
@@ -77,12 +79,64 @@ namespace Kale {
 		/**
 		 * The current animation index in animationInfo
 		 */
-		size_t animationIndex;
+		size_t animationIndex = 0;
 
 		/**
 		 * Whether or not we are to loop through the information in animationInfo in an infinite loop
 		 */
-		bool animationLoop;
+		bool animationLoop = false;
+
+		/**
+		 * The node woken whenever the states or animation change, nullptr if no node is to be woken
+		 */
+		Node* node = nullptr;
+
+		/**
+		 * A stage of the current animation as stored in binary scenes
+		 */
+		struct BinaryStage {
+			int32_t state;
+			float duration;
+		};
+
+		/**
+		 * Wakes the node if set, so the node responds to the change even if it was asleep
+		 */
+		void wakeNode() {
+			if (node != nullptr) node->wake();
+		}
+
+		/**
+		 * Copies the states & animation of another state animatable, leaving the node untouched
+		 * @param other The state animatable to copy from
+		 */
+		void copyStates(const StateAnimatable& other) {
+			state = other.state;
+			transitionState = other.transitionState;
+			transitioning = other.transitioning;
+			transitionTime = other.transitionTime;
+			transitionDuration = other.transitionDuration;
+			structures = other.structures;
+			animationInfo = other.animationInfo;
+			animationIndex = other.animationIndex;
+			animationLoop = other.animationLoop;
+		}
+
+		/**
+		 * Moves the states & animation of another state animatable, leaving the node untouched
+		 * @param other The state animatable to move from
+		 */
+		void moveStates(StateAnimatable&& other) {
+			state = other.state;
+			transitionState = other.transitionState;
+			transitioning = other.transitioning;
+			transitionTime = other.transitionTime;
+			transitionDuration = other.transitionDuration;
+			structures = std::move(other.structures);
+			animationInfo = std::move(other.animationInfo);
+			animationIndex = other.animationIndex;
+			animationLoop = other.animationLoop;
+		}
 		
 	public:
 
@@ -91,14 +145,55 @@ namespace Kale {
 		 */
 		StateAnimatable() {}
 
+		/**
+		 * Copy constructor, the node is not copied as it belongs to the state animatable being copied
+		 * @param other The state animatable to copy from
+		 */
+		StateAnimatable(const StateAnimatable& other) {
+			copyStates(other);
+		}
+
+		/**
+		 * Move constructor, the node is not moved as it belongs to the state animatable being moved from
+		 * @param other The state animatable to move from
+		 */
+		StateAnimatable(StateAnimatable&& other) noexcept {
+			moveStates(std::move(other));
+		}
+
+		/**
+		 * Copy assignment, keeps this state animatable's node and wakes it as the states have changed
+		 * @param other The state animatable to copy from
+		 * @returns This state animatable
+		 */
+		StateAnimatable& operator=(const StateAnimatable& other) {
+			if (this == &other) return *this;
+			copyStates(other);
+			wakeNode();
+			return *this;
+		}
+
+		/**
+		 * Move assignment, keeps this state animatable's node and wakes it as the states have changed
+		 * @param other The state animatable to move from
+		 * @returns This state animatable
+		 */
+		StateAnimatable& operator=(StateAnimatable&& other) noexcept {
+			if (this == &other) return *this;
+			moveStates(std::move(other));
+			wakeNode();
+			return *this;
+		}
+
 		/**
 		 * Creates a state animatable from a JSON config
 		 * @param json The json
 		 */
-		StateAnimatable(JSON json) {
-			// Loop through the structures & set them
-			for (const std::pair<std::string, S>& pair : json["structures"].get<std::unordered_map<std::string, S>>())
-				structures[std::stoi(pair.first)] = pair.second;
+		StateAnimatable(const JSON& json) {
+			// Loop through the structures & set them, converting each in place rather than through a copied map
+			const JSON& structuresJson = json.at("structures");
+			structures.reserve(structuresJson.size());
+			for (const auto& pair : structuresJson.items()) structures[std::stoi(pair.key())] = pair.value().template get<S>();
 			
 			// Set the first state if applicable
 			if (json.contains("state")) setState<int>(json["state"].get<int>());
@@ -106,16 +201,15 @@ namespace Kale {
 			// Start animating if applicable
 			if (json.contains("animation")) {
 				// Get the animation subset of the json
-				JSON animationInfo = json["animation"];
+				const JSON& animationInfo = json["animation"];
 
 				// Get the type of animation and convert it to lowercase (loop or once)
-				std::string type = animationInfo["type"].get<std::string>();
+				std::string type = animationInfo.at("type").get<std::string>();
 				std::transform(type.begin(), type.end(), type.begin(), [](char c) -> char { return std::tolower(c); });
 				
 				// Get the stages data
 				std::vector<std::pair<int, float>> stages;
-				std::vector<JSON> stagesJson = animationInfo["stages"].get<std::vector<JSON>>();
-				for (const JSON& json : stagesJson) stages.push_back(std::make_pair(json["state"].get<int>(), json["duration"].get<float>()));
+				for (const JSON& json : animationInfo.at("stages")) stages.push_back(std::make_pair(json.at("state").get<int>(), json.at("duration").get<float>()));
 
 				// Animate based on the type
 				if (type == "loop") animateLoop(stages);
@@ -123,6 +217,60 @@ namespace Kale {
 			}
 		}
 
+		/**
+		 * Creates a state animatable from a binary scene, restoring the exact state it was written in
+		 * @param reader The reader positioned at the state animatable
+		 */
+		StateAnimatable(BinarySceneReader& reader) {
+			state = reader.read<int32_t>();
+			transitionState = reader.read<int32_t>();
+			transitioning = reader.read<uint8_t>() != 0;
+			transitionTime = reader.read<float>();
+			transitionDuration = reader.read<float>();
+			animationIndex = static_cast<size_t>(reader.read<uint64_t>());
+			animationLoop = reader.read<uint8_t>() != 0;
+			for (const BinaryStage& stage : reader.readArray<BinaryStage>()) animationInfo.push_back(std::make_pair(stage.state, stage.duration));
+
+			uint64_t numStructures = reader.read<uint64_t>();
+			structures.reserve(static_cast<size_t>(numStructures));
+			for (uint64_t i = 0; i < numStructures; i++) {
+				int key = reader.read<int32_t>();
+				readBinary(reader, structures[key]);
+			}
+		}
+
+		/**
+		 * Writes the state animatable to a binary scene
+		 * @param writer The writer
+		 */
+		void write(BinarySceneWriter& writer) const {
+			writer.write(static_cast<int32_t>(state));
+			writer.write(static_cast<int32_t>(transitionState));
+			writer.write(static_cast<uint8_t>(transitioning));
+			writer.write(transitionTime);
+			writer.write(transitionDuration);
+			writer.write(static_cast<uint64_t>(animationIndex));
+			writer.write(static_cast<uint8_t>(animationLoop));
+
+			std::vector<BinaryStage> stages;
+			for (const std::pair<int, float>& stage : animationInfo) stages.push_back({stage.first, stage.second});
+			writer.writeArray<BinaryStage>(stages);
+
+			writer.write(static_cast<uint64_t>(structures.size()));
+			for (const std::pair<const int, S>& structure : structures) {
+				writer.write(static_cast<int32_t>(structure.first));
+				writeBinary(writer, structure.second);
+			}
+		}
+
+		/**
+		 * Sets the node to wake whenever the states or animation change, letting the node sleep while the animatable isn't transitioning
+		 * @param node The node to wake, nullptr if no node is to be woken
+		 */
+		void setNode(Node* node) {
+			this->node = node;
+		}
+
 		/**
 		 * Updates the state of the node
 		 * @note There is no need to call this manually, it is the responsibility of the node which contains this state animatable to update.
@@ -170,6 +318,7 @@ namespace Kale {
 		 */
 		template <typename T> void addStructure(T state, const S& structure) {
 			structures[static_cast<int>(state)] = structure;
+			wakeNode();
 		}
 
 		/**
@@ -204,6 +353,7 @@ namespace Kale {
 			transitionTime = 0.0f;
 			transitionDuration = duration;
 			transitionState = static_cast<int>(state);
+			wakeNode();
 		}
 
 		/**
@@ -222,6 +372,7 @@ namespace Kale {
 			transitionTime = 0.0f;
 			transitionDuration = stages[0].second;
 			transitionState = static_cast<int>(stages[0].first);
+			wakeNode();
 		}
 
 		/**
@@ -240,6 +391,7 @@ namespace Kale {
 			transitionTime = 0.0f;
 			transitionDuration = stages[0].second;
 			transitionState = static_cast<int>(stages[0].first);
+			wakeNode();
 		}
 
 		/**
@@ -252,6 +404,7 @@ namespace Kale {
 			animationInfo.clear();
 			transitioning = false;
 			this->state = static_cast<int>(state);
+			wakeNode();
 		}
 
 		/**
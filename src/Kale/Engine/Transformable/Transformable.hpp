@@ -47,7 +47,8 @@ namespace Kale {
 
 		/**
 		 * The FSM used for transform states. Transformables support FSM based animations, to use the FSM simply set the value of this optional and fill
-		 * the map. Access to the FSM must be externally synchronized if done from multiple threads.
+		 * the map. Access to the FSM must be externally synchronized if done from multiple threads. If the FSM is set after the node
+		 * is added to the scene, the node must be woken via Node::wake.
 		 */
 		std::optional<StateAnimatable<Transform>> transformFSM;
 
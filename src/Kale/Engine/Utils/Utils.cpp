@@ -20,6 +20,8 @@
 
 #include <iterator>
 #include <algorithm>
+#include <numeric>
+#include <cmath>
 
 using namespace Kale;
 
@@ -90,3 +92,387 @@ std::pair<std::vector<float>, std::vector<unsigned int>> Kale::triangulatePathFl
 
 	return output;
 }
+
+/**
+ * Splits a bezier in two at a given time
+ * @param bezier The bezier to split
+ * @param t The time to split at, from 0 to 1
+ * @returns The bezier before and after the time
+ */
+std::pair<CubicBezier, CubicBezier> Kale::splitBezier(const CubicBezier& bezier, float t) {
+	Vector2f a = bezier.start + (bezier.controlPoint1 - bezier.start) * t;
+	Vector2f b = bezier.controlPoint1 + (bezier.controlPoint2 - bezier.controlPoint1) * t;
+	Vector2f c = bezier.controlPoint2 + (bezier.end - bezier.controlPoint2) * t;
+	Vector2f ab = a + (b - a) * t;
+	Vector2f bc = b + (c - b) * t;
+	Vector2f point = ab + (bc - ab) * t;
+	return {CubicBezier{bezier.start, a, ab, point}, CubicBezier{point, bc, c, bezier.end}};
+}
+
+/**
+ * Flattens the beziers of a path into polylines, a new polyline starts wherever a bezier doesn't start at the end of the last
+ * @param path The path to flatten
+ * @param tolerance The maximum distance between the polylines and the beziers
+ * @returns The polylines
+ */
+std::vector<std::vector<Vector2f>> Kale::flattenPath(const Path& path, float tolerance) {
+	std::vector<std::vector<Vector2f>> polylines;
+	for (const CubicBezier& bezier : path.beziers) {
+		if (polylines.empty() || polylines.back().back() != bezier.start) polylines.push_back({bezier.start});
+		std::vector<Vector2f>& polyline = polylines.back();
+
+		// Lines across n equal steps of a cubic lie within an eighth of the largest second derivative over n squared of the curve
+		const Vector2f dd1 = bezier.start - bezier.controlPoint1 * 2.0f + bezier.controlPoint2;
+		const Vector2f dd2 = bezier.controlPoint1 - bezier.controlPoint2 * 2.0f + bezier.end;
+		const float maxSecondDerivative = 6.0f * std::sqrt(std::max(dd1.x * dd1.x + dd1.y * dd1.y, dd2.x * dd2.x + dd2.y * dd2.y));
+		const size_t numLines = static_cast<size_t>(std::clamp(std::ceil(std::sqrt(maxSecondDerivative / (8.0f * tolerance))), 1.0f, 1024.0f));
+
+		for (size_t i = 1; i < numLines; i++) {
+			float t = static_cast<float>(i) / static_cast<float>(numLines);
+			float a = 1.0f - t;
+			polyline.push_back(bezier.start * (a * a * a) + bezier.controlPoint1 * (3.0f * a * a * t) +
+				bezier.controlPoint2 * (3.0f * a * t * t) + bezier.end * (t * t * t));
+		}
+		polyline.push_back(bezier.end);
+	}
+	return polylines;
+}
+
+/**
+ * Triangulates the area within polylines filled by the even odd rule, the same rule the beziers of a path node are filled by.
+ * The area is split into trapezoids between each height a polyline vertex or crossing lies at, so holes, separate shapes and
+ * polylines crossing themselves are all respected.
+ * @param polylines The polylines, each treated as closed
+ * @returns A tuple of vectors for the vertices and indices
+ */
+std::pair<std::vector<Vector2f>, std::vector<unsigned int>> Kale::triangulateFill(const std::vector<std::vector<Vector2f>>& polylines) {
+	// Gather the edges from top to bottom, horizontal edges never bound a trapezoid
+	struct Edge {
+		Vector2f top, bottom;
+		float xAt(float y) const {
+			return top.x + (bottom.x - top.x) * (y - top.y) / (bottom.y - top.y);
+		}
+	};
+	std::vector<Edge> edges;
+	std::vector<float> heights;
+	for (const std::vector<Vector2f>& polyline : polylines) {
+		for (size_t i = 0; i < polyline.size(); i++) {
+			const Vector2f& a = polyline[i];
+			const Vector2f& b = polyline[(i + 1) % polyline.size()];
+			heights.push_back(a.y);
+			if (a.y == b.y) continue;
+			edges.push_back(a.y < b.y ? Edge{a, b} : Edge{b, a});
+		}
+	}
+	std::sort(edges.begin(), edges.end(), [](const Edge& a, const Edge& b) -> bool { return a.top.y < b.top.y; });
+	std::sort(heights.begin(), heights.end());
+	heights.erase(std::unique(heights.begin(), heights.end()), heights.end());
+
+	std::pair<std::vector<Vector2f>, std::vector<unsigned int>> output;
+	std::vector<Vector2f>& vertices = output.first;
+	std::vector<unsigned int>& elements = output.second;
+
+	// Sweep down each band between consecutive heights, the edges active within a band span all of it
+	std::vector<const Edge*> active;
+	std::vector<std::pair<float, float>> bands;
+	std::vector<size_t> order;
+	size_t nextEdge = 0;
+	for (size_t h = 0; h + 1 < heights.size(); h++) {
+		const float bandTop = heights[h];
+		active.erase(std::remove_if(active.begin(), active.end(), [&](const Edge* edge) -> bool {
+			return edge->bottom.y <= bandTop;
+		}), active.end());
+		while (nextEdge < edges.size() && edges[nextEdge].top.y <= bandTop) {
+			if (edges[nextEdge].bottom.y > bandTop) active.push_back(&edges[nextEdge]);
+			nextEdge++;
+		}
+		if (active.size() < 2) continue;
+
+		// Crossing edges swap order partway down a band, so the band is split at the first crossing until none remain
+		bands.assign(1, {bandTop, heights[h + 1]});
+		while (!bands.empty()) {
+			const auto [top, bottom] = bands.back();
+			bands.pop_back();
+			const float middle = (top + bottom) * 0.5f;
+			order.resize(active.size());
+			std::iota(order.begin(), order.end(), 0);
+			std::sort(order.begin(), order.end(), [&](size_t a, size_t b) -> bool { return active[a]->xAt(middle) < active[b]->xAt(middle); });
+
+			float crossing = bottom;
+			for (size_t i = 0; i + 1 < order.size(); i++) {
+				const Edge& a = *active[order[i]];
+				const Edge& b = *active[order[i + 1]];
+				float topGap = b.xAt(top) - a.xAt(top);
+				float bottomGap = b.xAt(bottom) - a.xAt(bottom);
+				if (topGap >= 0.0f && bottomGap >= 0.0f) continue;
+				float y = top + (bottom - top) * topGap / (topGap - bottomGap);
+				if (y > top && y < bottom) crossing = std::min(crossing, y);
+			}
+			if (crossing < bottom && bands.size() < 64) {
+				bands.push_back({crossing, bottom});
+				bands.push_back({top, crossing});
+				continue;
+			}
+
+			// Every other gap between the edges is within the path
+			for (size_t i = 0; i + 1 < order.size(); i += 2) {
+				const Edge& left = *active[order[i]];
+				const Edge& right = *active[order[i + 1]];
+				unsigned int first = static_cast<unsigned int>(vertices.size());
+				vertices.emplace_back(left.xAt(top), top);
+				vertices.emplace_back(right.xAt(top), top);
+				vertices.emplace_back(right.xAt(bottom), bottom);
+				vertices.emplace_back(left.xAt(bottom), bottom);
+				elements.insert(elements.end(), {first, first + 1, first + 2, first, first + 2, first + 3});
+			}
+		}
+	}
+
+	return output;
+}
+
+/**
+ * Triangulates the area within a radius of polylines, with round joins & caps
+ * @param polylines The polylines
+ * @param radius The radius of the stroke
+ * @param tolerance The maximum distance between the rounded joins & caps and true circles
+ * @returns A tuple of vectors for the vertices and indices
+ */
+std::pair<std::vector<Vector2f>, std::vector<unsigned int>> Kale::triangulateStroke(const std::vector<std::vector<Vector2f>>& polylines,
+	float radius, float tolerance) {
+	std::pair<std::vector<Vector2f>, std::vector<unsigned int>> output;
+	std::vector<Vector2f>& vertices = output.first;
+	std::vector<unsigned int>& elements = output.second;
+	if (radius <= 0.0f) return output;
+
+	// The largest angle an arc step can cover while its chord stays within the tolerance of the circle
+	const float maxStep = 2.0f * std::acos(std::clamp(1.0f - tolerance / radius, -1.0f, 1.0f));
+	const auto addArc = [&](const Vector2f& center, float startAngle, float sweep) {
+		size_t numSteps = static_cast<size_t>(std::clamp(std::ceil(std::abs(sweep) / std::max(maxStep, 0.01f)), 1.0f, 256.0f));
+		unsigned int centerIndex = static_cast<unsigned int>(vertices.size());
+		vertices.push_back(center);
+		for (size_t i = 0; i <= numSteps; i++) {
+			float angle = startAngle + sweep * static_cast<float>(i) / static_cast<float>(numSteps);
+			vertices.emplace_back(center.x + std::cos(angle) * radius, center.y + std::sin(angle) * radius);
+			if (i > 0) elements.insert(elements.end(), {centerIndex, centerIndex + static_cast<unsigned int>(i),
+				centerIndex + static_cast<unsigned int>(i) + 1});
+		}
+	};
+
+	std::vector<Vector2f> points;
+	for (const std::vector<Vector2f>& polyline : polylines) {
+		// Skip repeated points, which have no direction to stroke along
+		points.clear();
+		for (const Vector2f& point : polyline) {
+			if (points.empty() || std::abs(point.x - points.back().x) + std::abs(point.y - points.back().y) > 1e-6f)
+				points.push_back(point);
+		}
+		if (points.size() == 1) {
+			addArc(points.front(), 0.0f, 2.0f * PI);
+			continue;
+		}
+
+		Vector2f previousDirection;
+		for (size_t i = 0; i + 1 < points.size(); i++) {
+			Vector2f delta = points[i + 1] - points[i];
+			Vector2f direction = delta / std::sqrt(delta.x * delta.x + delta.y * delta.y);
+			Vector2f normal(-direction.y * radius, direction.x * radius);
+
+			// A rectangle along the line
+			unsigned int first = static_cast<unsigned int>(vertices.size());
+			vertices.push_back(points[i] + normal);
+			vertices.push_back(points[i] - normal);
+			vertices.push_back(points[i + 1] - normal);
+			vertices.push_back(points[i + 1] + normal);
+			elements.insert(elements.end(), {first, first + 1, first + 2, first, first + 2, first + 3});
+
+			// A round cap at the start, or a round join filling the gap on the outside of the turn from the last line
+			float normalAngle = std::atan2(direction.x, -direction.y);
+			if (i == 0) addArc(points[i], normalAngle, PI);
+			else {
+				float turn = std::atan2(previousDirection.x * direction.y - previousDirection.y * direction.x,
+					previousDirection.x * direction.x + previousDirection.y * direction.y);
+				float previousNormalAngle = std::atan2(previousDirection.x, -previousDirection.y);
+				addArc(points[i], turn > 0.0f ? previousNormalAngle + PI : previousNormalAngle, turn);
+			}
+			if (i + 2 == points.size()) addArc(points[i + 1], normalAngle + PI, PI);
+			previousDirection = direction;
+		}
+	}
+
+	return output;
+}
+
+/**
+ * Calculates the k, l & m coordinates of the implicit form of a cubic bezier at each of its control points (Loop & Blinn,
+ * Resolution Independent Curve Rendering using Programmable Graphics Hardware). The coordinates are linear across the plane,
+ * so k^3 - lm interpolated across triangles of the control points is zero along the curve and changes sign across it.
+ * @param bezier The bezier
+ * @param splitTime Set to a time within the bezier the bezier should be split at, where it inflects, loops or has a cusp
+ * @returns The coordinates at the start, both control points and end, or nullopt if the bezier is a straight line
+ */
+std::optional<std::array<Vector3f, 4>> Kale::calculateCurveCoordinates(const CubicBezier& bezier, std::optional<float>& splitTime) {
+	splitTime.reset();
+
+	// Classify relative to the size of the bezier, so the thresholds don't depend on the units of the path
+	const std::array<Vector2f, 4> points = {bezier.start, bezier.controlPoint1, bezier.controlPoint2, bezier.end};
+	float extent = 0.0f;
+	for (const Vector2f& point : points)
+		extent = std::max({extent, std::abs(point.x - bezier.start.x), std::abs(point.y - bezier.start.y)});
+	if (extent <= 0.0f) return std::nullopt;
+	std::array<Vector3f, 4> b;
+	for (size_t i = 0; i < 4; i++) b[i] = Vector3f((points[i].x - bezier.start.x) / extent, (points[i].y - bezier.start.y) / extent, 1.0f);
+
+	const auto cross = [](const Vector3f& u, const Vector3f& v) -> Vector3f {
+		return Vector3f(u.y * v.z - u.z * v.y, u.z * v.x - u.x * v.z, u.x * v.y - u.y * v.x);
+	};
+	const auto dot = [](const Vector3f& u, const Vector3f& v) -> float {
+		return u.x * v.x + u.y * v.y + u.z * v.z;
+	};
+	const float a1 = dot(b[0], cross(b[3], b[2]));
+	const float a2 = dot(b[1], cross(b[0], b[3]));
+	const float a3 = dot(b[2], cross(b[1], b[0]));
+	float d1 = a1 - 2.0f * a2 + 3.0f * a3;
+	float d2 = -a2 + 3.0f * a3;
+	float d3 = 3.0f * a3;
+	const float length = std::sqrt(d1 * d1 + d2 * d2 + d3 * d3);
+	constexpr float epsilon = 1e-5f;
+	if (length < epsilon) return std::nullopt;
+	d1 /= length;
+	d2 /= length;
+	d3 /= length;
+
+	const auto splitAt = [&](float s, float t) {
+		if (std::abs(t) < epsilon) return;
+		float time = s / t;
+		if (time > 1e-3f && time < 1.0f - 1e-3f && !splitTime.has_value()) splitTime = time;
+	};
+
+	constexpr float oneThird = 1.0f / 3.0f;
+	constexpr float twoThirds = 2.0f / 3.0f;
+	std::array<Vector3f, 4> klm;
+	const float discriminant = 3.0f * d2 * d2 - 4.0f * d1 * d3;
+
+	// Quadratic, which is its own implicit form
+	if (std::abs(d1) < epsilon && std::abs(d2) < epsilon) {
+		klm = {Vector3f(0.0f, 0.0f, 0.0f), Vector3f(oneThird, 0.0f, oneThird), Vector3f(twoThirds, oneThird, twoThirds),
+			Vector3f(1.0f, 1.0f, 1.0f)};
+	}
+
+	// Cusp with an inflection at infinity
+	else if (std::abs(d1) < epsilon) {
+		const float ls = d3;
+		const float lt = 3.0f * d2;
+		const float lsMinusLt = ls - lt;
+		klm = {Vector3f(ls, ls * ls * ls, 1.0f), Vector3f(ls - oneThird * lt, ls * ls * lsMinusLt, 1.0f),
+			Vector3f(ls - twoThirds * lt, lsMinusLt * lsMinusLt * ls, 1.0f), Vector3f(lsMinusLt, lsMinusLt * lsMinusLt * lsMinusLt, 1.0f)};
+		splitAt(ls, lt);
+	}
+
+	// Serpentine, or a cusp when the discriminant is zero, with up to two inflections
+	else if (discriminant >= 0.0f) {
+		const float root = std::sqrt(3.0f * discriminant);
+		const float ls = 3.0f * d2 - root;
+		const float lt = 6.0f * d1;
+		const float ms = 3.0f * d2 + root;
+		const float mt = lt;
+		const float ltMinusLs = lt - ls;
+		const float mtMinusMs = mt - ms;
+		klm = {Vector3f(ls * ms, ls * ls * ls, ms * ms * ms),
+			Vector3f(oneThird * (3.0f * ls * ms - ls * mt - lt * ms), ls * ls * (ls - lt), ms * ms * (ms - mt)),
+			Vector3f(oneThird * (lt * (mt - 2.0f * ms) + ls * (3.0f * ms - 2.0f * mt)), ltMinusLs * ltMinusLs * ls, mtMinusMs * mtMinusMs * ms),
+			Vector3f(ltMinusLs * mtMinusMs, -(ltMinusLs * ltMinusLs * ltMinusLs), -(mtMinusMs * mtMinusMs * mtMinusMs))};
+		splitAt(ls, lt);
+		splitAt(ms, mt);
+	}
+
+	// Loop, split at the double point so the other branch of the implicit form doesn't cut through the triangles
+	else {
+		const float root = std::sqrt(-discriminant);
+		const float ls = d2 - root;
+		const float lt = 2.0f * d1;
+		const float ms = d2 + root;
+		const float mt = lt;
+		klm = {Vector3f(ls * ms, ls * ls * ms, ls * ms * ms),
+			Vector3f(oneThird * (-ls * mt - lt * ms + 3.0f * ls * ms), -oneThird * ls * (ls * (mt - 3.0f * ms) + 2.0f * lt * ms),
+				-oneThird * ms * (ls * (2.0f * mt - 3.0f * ms) + lt * ms)),
+			Vector3f(oneThird * (lt * (mt - 2.0f * ms) + ls * (3.0f * ms - 2.0f * mt)), oneThird * (lt - ls) * (ls * (2.0f * mt - 3.0f * ms) + lt * ms),
+				oneThird * (mt - ms) * (ls * (mt - 3.0f * ms) + 2.0f * lt * ms)),
+			Vector3f((lt - ls) * (mt - ms), -(lt - ls) * (lt - ls) * (mt - ms), -(lt - ls) * (mt - ms) * (mt - ms))};
+		splitAt(ls, lt);
+		splitAt(ms, mt);
+	}
+
+	return klm;
+}
+
+/**
+ * Triangulates a path to be filled through the stencil buffer by the even odd rule. Every fragment covered an odd number of
+ * times by the triangles, excluding the fragments where the implicit form of their curve is positive, is within the path.
+ * The triangles fan from the start of the path to the ends of each bezier, and cover each bezier's control points with the
+ * implicit form of the bezier so only the area between the bezier and the line between its ends is counted.
+ * @param path The path to triangulate
+ * @returns A tuple of vectors for the vertices and indices
+ */
+std::pair<std::vector<CurveVertex>, std::vector<unsigned int>> Kale::triangulateCurves(const Path& path) {
+	std::pair<std::vector<CurveVertex>, std::vector<unsigned int>> output;
+	std::vector<CurveVertex>& vertices = output.first;
+	std::vector<unsigned int>& elements = output.second;
+	if (path.beziers.empty()) return output;
+
+	// Coordinates where the implicit form is negative everywhere, for triangles counted in full
+	const Vector3f solid(0.0f, 1.0f, 1.0f);
+	const Vector2f anchor = path.beziers.front().start;
+	const auto addTriangle = [&](const CurveVertex& a, const CurveVertex& b, const CurveVertex& c) {
+		unsigned int first = static_cast<unsigned int>(vertices.size());
+		vertices.insert(vertices.end(), {a, b, c});
+		elements.insert(elements.end(), {first, first + 1, first + 2});
+	};
+
+	// The control polygon of a bezier with no inflection or loop, once convex, holds only the area between the bezier & its ends
+	const auto isConvex = [](const CubicBezier& bezier) -> bool {
+		const std::array<Vector2f, 4> points = {bezier.start, bezier.controlPoint1, bezier.controlPoint2, bezier.end};
+		bool positive = false, negative = false;
+		for (size_t i = 0; i < 4; i++) {
+			Vector2f u = points[(i + 1) % 4] - points[i];
+			Vector2f v = points[(i + 2) % 4] - points[(i + 1) % 4];
+			float turn = u.x * v.y - u.y * v.x;
+			positive |= turn > 0.0f;
+			negative |= turn < 0.0f;
+		}
+		return !(positive && negative);
+	};
+
+	std::vector<std::pair<CubicBezier, size_t>> pieces;
+	for (const CubicBezier& bezier : path.beziers) {
+		pieces.push_back({bezier, 0});
+		while (!pieces.empty()) {
+			const auto [piece, depth] = pieces.back();
+			pieces.pop_back();
+
+			// Split where the bezier inflects, loops or has a cusp, then wherever its control polygon still isn't convex
+			std::optional<float> splitTime;
+			std::optional<std::array<Vector3f, 4>> klm = calculateCurveCoordinates(piece, splitTime);
+			if (klm.has_value() && depth < 8 && (splitTime.has_value() || !isConvex(piece))) {
+				std::pair<CubicBezier, CubicBezier> split = splitBezier(piece, splitTime.value_or(0.5f));
+				pieces.push_back({split.second, depth + 1});
+				pieces.push_back({split.first, depth + 1});
+				continue;
+			}
+
+			addTriangle({anchor, solid}, {piece.start, solid}, {piece.end, solid});
+			if (!klm.has_value()) continue;
+
+			// The middle of the line between the ends lies on the inside of the curve, which the implicit form must be negative on
+			std::array<Vector3f, 4>& coordinates = *klm;
+			Vector3f middle = (coordinates[0] + coordinates[3]) * 0.5f;
+			if (middle.x * middle.x * middle.x - middle.y * middle.z > 0.0f) {
+				for (Vector3f& coordinate : coordinates) coordinate = Vector3f(-coordinate.x, -coordinate.y, coordinate.z);
+			}
+			addTriangle({piece.start, coordinates[0]}, {piece.controlPoint1, coordinates[1]}, {piece.controlPoint2, coordinates[2]});
+			addTriangle({piece.start, coordinates[0]}, {piece.controlPoint2, coordinates[2]}, {piece.end, coordinates[3]});
+		}
+	}
+
+	return output;
+}
@@ -16,13 +16,32 @@
 
 #pragma once
 
+#include <Kale/Math/Path/Path.hpp>
 #include <Kale/Math/Vector/Vector.hpp>
 
 #include <utility>
 #include <vector>
+#include <optional>
+#include <array>
 
 namespace Kale {
 
+	/**
+	 * A vertex of the triangles of a curve filled path, the implicit form of the curve is k^3 - lm and is negative within the path
+	 */
+	struct CurveVertex {
+
+		/**
+		 * The position of the vertex
+		 */
+		Vector2f position;
+
+		/**
+		 * The k, l & m coordinates of the cubic's implicit form at the vertex
+		 */
+		Vector3f klm;
+	};
+
 	/**
 	 * Triangulates the given path and returns both the vertices and indices
 	 * @param begin The beginning of the path to triangulate
@@ -38,4 +57,59 @@ namespace Kale {
 	 * @returns A tuple of vectors for the vertices and indices
 	 */
 	std::pair<std::vector<float>, std::vector<unsigned int>> triangulatePathFloat(const Vector2f* begin, const Vector2f* end);
+
+	/**
+	 * Splits a bezier in two at a given time
+	 * @param bezier The bezier to split
+	 * @param t The time to split at, from 0 to 1
+	 * @returns The bezier before and after the time
+	 */
+	std::pair<CubicBezier, CubicBezier> splitBezier(const CubicBezier& bezier, float t);
+
+	/**
+	 * Flattens the beziers of a path into polylines, a new polyline starts wherever a bezier doesn't start at the end of the last
+	 * @param path The path to flatten
+	 * @param tolerance The maximum distance between the polylines and the beziers
+	 * @returns The polylines
+	 */
+	std::vector<std::vector<Vector2f>> flattenPath(const Path& path, float tolerance);
+
+	/**
+	 * Triangulates the area within polylines filled by the even odd rule, the same rule the beziers of a path node are filled by.
+	 * The area is split into trapezoids between each height a polyline vertex or crossing lies at, so holes, separate shapes and
+	 * polylines crossing themselves are all respected.
+	 * @param polylines The polylines, each treated as closed
+	 * @returns A tuple of vectors for the vertices and indices
+	 */
+	std::pair<std::vector<Vector2f>, std::vector<unsigned int>> triangulateFill(const std::vector<std::vector<Vector2f>>& polylines);
+
+	/**
+	 * Triangulates the area within a radius of polylines, with round joins & caps
+	 * @param polylines The polylines
+	 * @param radius The radius of the stroke
+	 * @param tolerance The maximum distance between the rounded joins & caps and true circles
+	 * @returns A tuple of vectors for the vertices and indices
+	 */
+	std::pair<std::vector<Vector2f>, std::vector<unsigned int>> triangulateStroke(const std::vector<std::vector<Vector2f>>& polylines,
+		float radius, float tolerance);
+
+	/**
+	 * Calculates the k, l & m coordinates of the implicit form of a cubic bezier at each of its control points (Loop & Blinn,
+	 * Resolution Independent Curve Rendering using Programmable Graphics Hardware). The coordinates are linear across the plane,
+	 * so k^3 - lm interpolated across triangles of the control points is zero along the curve and changes sign across it.
+	 * @param bezier The bezier
+	 * @param splitTime Set to a time within the bezier the bezier should be split at, where it inflects, loops or has a cusp
+	 * @returns The coordinates at the start, both control points and end, or nullopt if the bezier is a straight line
+	 */
+	std::optional<std::array<Vector3f, 4>> calculateCurveCoordinates(const CubicBezier& bezier, std::optional<float>& splitTime);
+
+	/**
+	 * Triangulates a path to be filled through the stencil buffer by the even odd rule. Every fragment covered an odd number of
+	 * times by the triangles, excluding the fragments where the implicit form of their curve is positive, is within the path.
+	 * The triangles fan from the start of the path to the ends of each bezier, and cover each bezier's control points with the
+	 * implicit form of the bezier so only the area between the bezier and the line between its ends is counted.
+	 * @param path The path to triangulate
+	 * @returns A tuple of vectors for the vertices and indices
+	 */
+	std::pair<std::vector<CurveVertex>, std::vector<unsigned int>> triangulateCurves(const Path& path);
 }
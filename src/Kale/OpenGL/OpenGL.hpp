@@ -19,5 +19,6 @@
 #include "Buffer/Buffer.hpp"
 #include "Core/Core.hpp"
 #include "Shader/Shader.hpp"
+#include "TextureBuffer/TextureBuffer.hpp"
 #include "Utils/Utils.hpp"
 #include "VertexArray/VertexArray.hpp"
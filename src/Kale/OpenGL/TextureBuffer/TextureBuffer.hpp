@@ -0,0 +1,183 @@
+/*
+   Copyright 2022 Rishi Challa
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+	   http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+
+#pragma once
+
+#ifdef KALE_OPENGL
+
+#include <Kale/OpenGL/Buffer/Buffer.hpp>
+#include <Kale/OpenGL/Utils/Utils.hpp>
+
+#include <cstddef>
+
+#include <glad/glad.h>
+
+namespace Kale::OpenGL {
+
+	/**
+	 * The format of each texel within a texture buffer
+	 */
+	enum class TextureBufferFormat : GLenum {
+		R32F = GL_R32F,
+		RG32F = GL_RG32F,
+		RGBA32F = GL_RGBA32F,
+		R32I = GL_R32I,
+		RGBA32I = GL_RGBA32I
+	};
+
+	/**
+	 * A buffer of data on the GPU read by shaders as a samplerBuffer via texelFetch, allowing shaders to read far more data than
+	 * fits within their uniforms
+	 * @tparam T The type of each texel, must match the size of the format
+	 */
+	template <typename T>
+	class TextureBuffer {
+	private:
+
+		/**
+		 * The location of the buffer holding the data for opengl accessing
+		 */
+		unsigned int buffer;
+
+		/**
+		 * The location of the texture viewing the buffer for opengl accessing
+		 */
+		unsigned int texture;
+
+		/**
+		 * The format of each texel
+		 */
+		TextureBufferFormat format;
+
+		/**
+		 * The number of texels the buffer holds
+		 */
+		size_t length;
+
+	public:
+
+		/**
+		 * Creates an empty texture buffer
+		 * @param format The format of each texel
+		 */
+		TextureBuffer(TextureBufferFormat format) : format(format), length(0) {
+			glGenBuffers(1, &buffer);
+			glGenTextures(1, &texture);
+			glBindBuffer(getEnumValue(BufferType::TextureBuffer), buffer);
+			glBindTexture(GL_TEXTURE_BUFFER, texture);
+			glTexBuffer(GL_TEXTURE_BUFFER, getEnumValue(format), buffer);
+		}
+
+		/**
+		 * Texture buffers do not support copying
+		 */
+		TextureBuffer(const TextureBuffer& other) = delete;
+
+		/**
+		 * Texture buffers do not support copying
+		 */
+		void operator=(const TextureBuffer& other) = delete;
+
+		/**
+		 * Destroys the texture buffer and frees resources from the GPU
+		 */
+		~TextureBuffer() {
+			glDeleteTextures(1, &texture);
+			glDeleteBuffers(1, &buffer);
+		}
+
+		/**
+		 * Reallocates the buffer on the GPU and uploads the given data, the previous storage is orphaned so draws still reading
+		 * it are not waited on
+		 * @param data The data to upload
+		 * @param count The number of texels to upload
+		 * @param usage The usage of the buffer
+		 */
+		void upload(const T* data, size_t count, BufferUsage usage) {
+			glBindBuffer(getEnumValue(BufferType::TextureBuffer), buffer);
+			glBufferData(getEnumValue(BufferType::TextureBuffer), static_cast<GLsizeiptr>(sizeof(T) * count), data, getEnumValue(usage));
+			length = count;
+		}
+
+		/**
+		 * Grows the buffer on the GPU to hold at least the given number of texels, keeping the texels it already holds. The data is
+		 * copied on the GPU, so it never has to be kept or uploaded again from the CPU.
+		 * @param count The minimum number of texels
+		 * @param usage The usage of the buffer
+		 */
+		void reserve(size_t count, BufferUsage usage) {
+			if (count <= length) return;
+
+			unsigned int grownBuffer;
+			glGenBuffers(1, &grownBuffer);
+			glBindBuffer(GL_COPY_WRITE_BUFFER, grownBuffer);
+			glBufferData(GL_COPY_WRITE_BUFFER, static_cast<GLsizeiptr>(sizeof(T) * count), nullptr, getEnumValue(usage));
+			if (length > 0) {
+				glBindBuffer(GL_COPY_READ_BUFFER, buffer);
+				glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER, 0, 0, static_cast<GLsizeiptr>(sizeof(T) * length));
+			}
+
+			glDeleteBuffers(1, &buffer);
+			buffer = grownBuffer;
+			glBindTexture(GL_TEXTURE_BUFFER, texture);
+			glTexBuffer(GL_TEXTURE_BUFFER, getEnumValue(format), buffer);
+			length = count;
+		}
+
+		/**
+		 * Replaces a range of texels within the buffer, the range must lie within the buffer
+		 * @param offset The index of the first texel to replace
+		 * @param data The data to replace the texels with
+		 * @param count The number of texels to replace
+		 */
+		void update(size_t offset, const T* data, size_t count) {
+			glBindBuffer(getEnumValue(BufferType::TextureBuffer), buffer);
+			glBufferSubData(getEnumValue(BufferType::TextureBuffer), static_cast<GLintptr>(sizeof(T) * offset),
+				static_cast<GLsizeiptr>(sizeof(T) * count), data);
+		}
+
+		/**
+		 * Gets the number of texels the buffer holds
+		 * @returns The number of texels
+		 */
+		[[nodiscard]] size_t size() const {
+			return length;
+		}
+
+		/**
+		 * Binds the texture buffer to a texture unit for use by shaders
+		 * @param unit The index of the texture unit, the value the shader's samplerBuffer uniform must be set to
+		 */
+		void bind(unsigned int unit) const {
+			glActiveTexture(GL_TEXTURE0 + unit);
+			glBindTexture(GL_TEXTURE_BUFFER, texture);
+		}
+
+		/**
+		 * Gets the maximum number of texels any texture buffer can hold on this device
+		 * @returns The maximum number of texels
+		 */
+		[[nodiscard]] static size_t getMaxSize() {
+			GLint maxSize = 0;
+			glGetIntegerv(GL_MAX_TEXTURE_BUFFER_SIZE, &maxSize);
+			return static_cast<size_t>(maxSize);
+		}
+	};
+
+}
+
+#endif
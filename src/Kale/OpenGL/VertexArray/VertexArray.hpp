@@ -310,6 +310,17 @@ namespace Kale::OpenGL {
 			glDrawElements(GL_TRIANGLES, static_cast<GLsizei>(elements.data.size()), GL_UNSIGNED_INT, nullptr);
 		}
 
+		/**
+		 * Draws multiple instances of the vertex array as triangles in a single draw call, shaders tell the instances apart by
+		 * gl_InstanceID
+		 * @param count The number of instances to draw
+		 */
+		void drawInstanced(size_t count) const {
+			bind();
+			glDrawElementsInstanced(GL_TRIANGLES, static_cast<GLsizei>(elements.data.size()), GL_UNSIGNED_INT, nullptr,
+				static_cast<GLsizei>(count));
+		}
+
 		/**
 		 * Draws the vertex array as triangles directly using the vertex buffer
 		 */